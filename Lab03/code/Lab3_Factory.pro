@@ -2,34 +2,21 @@ QT       += core gui widgets
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++17
-
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
-LIBS += -lpcosynchro
+include(simulation.pri)
 
 SOURCES += \
     display.cpp \
-    extractor.cpp \
-    factory.cpp \
     main.cpp \
     mainwindow.cpp \
-    seller.cpp \
-    utils.cpp \
-    wholesale.cpp \
     windowinterface.cpp
 
 HEADERS += \
-    costs.h \
     display.h \
-    extractor.h \
-    factory.h \
     mainwindow.h \
-    seller.h \
-    utils.h \
-    wholesale.h \
     windowinterface.h
 
 FORMS += \
@@ -0,0 +1,25 @@
+# Version sans affichage de la simulation : aucune dépendance à Qt Widgets,
+# les vendeurs publient leur état dans une HeadlessInterface qui se contente
+# de compter les évènements. Permet de lancer de grandes économies sur un
+# serveur et d'en mesurer le débit.
+
+QT = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = Lab3_Factory_headless
+
+include(simulation.pri)
+
+SOURCES += \
+    headlessinterface.cpp \
+    main_headless.cpp
+
+HEADERS += \
+    headlessinterface.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,24 @@
+# Bancs d'essai des chemins critiques de la simulation. Chaque suite affiche
+# ses résultats au format `suite;bench;threads;operations;ns/op;allocs/op`, comparable
+# d'un commit à l'autre.
+
+QT = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = Lab3_Benchmarks
+
+include(../simulation.pri)
+
+SOURCES += \
+    ../headlessinterface.cpp \
+    bench_economy.cpp \
+    bench_random.cpp \
+    bench_seller.cpp \
+    bench_trade.cpp \
+    main.cpp
+
+HEADERS += \
+    ../headlessinterface.h \
+    benchmark.h
@@ -0,0 +1,87 @@
+/**
+ * @file bench_economy.cpp
+ * @brief Débit d'échanges d'économies entières de taille croissante.
+ *
+ * Deux mesures par taille :
+ * - `events_*` : ordonnanceur à évènements discrets, graine et durée simulée fixes.
+ *   Le travail effectué est le même d'un commit à l'autre tant que le comportement
+ *   des vendeurs ne change pas : le temps par vente est directement comparable.
+ * - `pool_fast_*` : pool de threads et horloge au plus vite pendant une durée réelle
+ *   fixe, pour le débit multi-thread (moins reproductible).
+ * Les opérations comptées sont les ventes réussies (TradeOutcome::Success) ; les
+ * allocations par vente comprennent le lancement des threads des vendeurs.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "benchmark.h"
+#include "utils.h"
+
+#define ECONOMY_SEED 1
+#define ECONOMY_SIMULATED_S 200
+#define ECONOMY_REAL_MS 1000
+
+namespace {
+
+const int economySizes[] = {30, 300, 3000};
+
+struct Outcome {
+    std::uint64_t nbTrades;
+    double elapsedNs;
+};
+
+/**
+ * @brief Fait tourner une économie de `size` vendeurs (45 % de mines, 45 % d'usines, 10 % de grossistes)
+ */
+Outcome runEconomy(int size, const SimulationOptions& options, int realDurationMs) {
+    /* Les messages de Utils ne doivent pas se mêler aux résultats */
+    std::streambuf* output = std::cout.rdbuf(nullptr);
+
+    Utils utils(size * 45 / 100, size * 45 / 100, size / 10, options);
+    /* La mise en place du réseau n'est pas comptée */
+    std::uint64_t allocations = getNbAllocations();
+    auto start = std::chrono::steady_clock::now();
+
+    auto deadline = start + std::chrono::milliseconds(realDurationMs);
+    while (!utils.isFinished() && (realDurationMs == 0 || std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    utils.externalEndService();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    measuredAllocations = getNbAllocations() - allocations;
+
+    std::cout.rdbuf(output);
+    std::cout.clear();
+
+    return {utils.getTradeCounts()[std::size_t(TradeOutcome::Success)], elapsed.count()};
+}
+
+} // namespace
+
+void runEconomyBenchmarks() {
+    for (int size : economySizes) {
+        SimulationOptions options;
+        options.seed = ECONOMY_SEED;
+        options.auditPeriodUs = 0;
+        options.scheduler = SchedulerMode::DiscreteEvent;
+        options.simulatedDurationUs = std::uint64_t(ECONOMY_SIMULATED_S) * 1000000;
+
+        Outcome outcome = runEconomy(size, options, 0);
+        printResult("economy", "events_" + std::to_string(size), 1, outcome.nbTrades,
+                    outcome.nbTrades ? outcome.elapsedNs / outcome.nbTrades : 0.0);
+
+        options.scheduler = SchedulerMode::WorkStealing;
+        options.clock = ClockMode::Fast;
+        options.simulatedDurationUs = 0;
+
+        outcome = runEconomy(size, options, ECONOMY_REAL_MS);
+        printResult("economy", "pool_fast_" + std::to_string(size),
+                    int(std::max(1u, std::thread::hardware_concurrency())), outcome.nbTrades,
+                    outcome.nbTrades ? outcome.elapsedNs / outcome.nbTrades : 0.0);
+    }
+}
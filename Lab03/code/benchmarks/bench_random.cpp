@@ -0,0 +1,57 @@
+/**
+ * @file bench_random.cpp
+ * @brief Coût d'un tirage aléatoire : ancienne construction par appel contre ThreadRandom.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "benchmark.h"
+#include "seller.h"
+#include "threadrandom.h"
+
+#define RANDOM_ITERATIONS 200000
+
+namespace {
+
+// Tirage tel qu'il était fait dans Seller::chooseRandomSeller avant ThreadRandom
+int legacyPick(std::vector<int>& values) {
+    std::vector<int> out;
+    std::sample(values.begin(), values.end(), std::back_inserter(out),
+                1, std::mt19937{std::random_device{}()});
+    return out.front();
+}
+
+} // namespace
+
+void runRandomBenchmarks() {
+    std::vector<int> values(16);
+    std::iota(values.begin(), values.end(), 0);
+
+    double ns = measureNsPerOp(RANDOM_ITERATIONS, [&] {
+        doNotOptimize(legacyPick(values));
+    });
+    printResult("random", "mt19937_random_device_per_call", 1, RANDOM_ITERATIONS, ns);
+
+    ns = measureNsPerOp(RANDOM_ITERATIONS, [&] {
+        doNotOptimize(rand() % int(values.size()));
+    });
+    printResult("random", "global_rand", 1, RANDOM_ITERATIONS, ns);
+
+    ThreadRandom::seed(1);
+    ns = measureNsPerOp(RANDOM_ITERATIONS, [&] {
+        doNotOptimize(values[ThreadRandom::bounded(0, int(values.size()) - 1)]);
+    });
+    printResult("random", "thread_random_bounded", 1, RANDOM_ITERATIONS, ns);
+
+    ItemsForSale items{1, 0, 3, 0, 2, 1};
+    ns = measureNsPerOp(RANDOM_ITERATIONS, [&] {
+        doNotOptimize(Seller::chooseRandomItem(items));
+    });
+    printResult("random", "choose_random_item", 1, RANDOM_ITERATIONS, ns);
+}
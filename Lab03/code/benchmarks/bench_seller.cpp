@@ -0,0 +1,63 @@
+/**
+ * @file bench_seller.cpp
+ * @brief Coût des opérations courantes d'un vendeur : choix aléatoires et lecture des stocks.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark.h"
+#include "extractor.h"
+#include "factory.h"
+#include "threadrandom.h"
+#include "wholesale.h"
+
+#define SELLER_ITERATIONS 1000000
+#define SELLER_NB_SELLERS 16
+
+void runSellerBenchmarks() {
+    ThreadRandom::seed(1);
+
+    std::vector<std::unique_ptr<Seller>> owned;
+    std::vector<Seller*> sellers;
+    for (int i = 0; i < SELLER_NB_SELLERS; ++i) {
+        owned.push_back(std::make_unique<CopperExtractor>(i, 0));
+        sellers.push_back(owned.back().get());
+    }
+
+    double ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(Seller::chooseRandomSeller(sellers));
+    });
+    printResult("seller", "choose_random_seller_16", 1, SELLER_ITERATIONS, ns);
+
+    ItemsForSale items{1, 0, 3, 0, 2, 1};
+    ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(Seller::chooseRandomItem(items));
+    });
+    printResult("seller", "choose_random_item", 1, SELLER_ITERATIONS, ns);
+
+    SandExtractor extractor(SELLER_NB_SELLERS, 0);
+    ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(extractor.getItemsForSale());
+    });
+    printResult("seller", "get_items_for_sale_extractor", 1, SELLER_ITERATIONS, ns);
+
+    Factory factory(SELLER_NB_SELLERS + 1, 0, ItemType::Chip);
+    ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(factory.getItemsForSale());
+    });
+    printResult("seller", "get_items_for_sale_factory", 1, SELLER_ITERATIONS, ns);
+
+    Wholesale wholesale(SELLER_NB_SELLERS + 2, 0);
+    ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(wholesale.getItemsForSale());
+    });
+    printResult("seller", "get_items_for_sale_wholesale", 1, SELLER_ITERATIONS, ns);
+
+    ns = measureNsPerOp(SELLER_ITERATIONS, [&] {
+        doNotOptimize(wholesale.getStockSnapshot().read());
+    });
+    printResult("seller", "stock_snapshot_read", 1, SELLER_ITERATIONS, ns);
+}
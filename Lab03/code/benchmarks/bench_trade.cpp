@@ -0,0 +1,95 @@
+/**
+ * @file bench_trade.cpp
+ * @brief Coût d'une vente (trade, tradeBatch) selon le nombre d'acheteurs concurrents.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "benchmark.h"
+#include "extractor.h"
+#include "wholesale.h"
+
+#define TRADE_ITERATIONS 20000
+
+namespace {
+
+const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+// Types vendus par le grossiste du banc, un par acheteur à tour de rôle
+const ItemType spreadItems[] = {ItemType::Sand, ItemType::Copper, ItemType::Petrol,
+                                ItemType::Chip, ItemType::Plastic, ItemType::Robot};
+
+class BenchExtractor : public SandExtractor {
+public:
+    using SandExtractor::SandExtractor;
+    void fill(int qty) { restock(ItemType::Sand, qty); }
+};
+
+class BenchWholesale : public Wholesale {
+public:
+    using Wholesale::Wholesale;
+    void fill(ItemType item, int qty) { restock(item, qty); }
+};
+
+class BenchShardedWholesale : public ShardedWholesale {
+public:
+    using ShardedWholesale::ShardedWholesale;
+    void fill(ItemType item, int qty) { restock(item, qty); }
+};
+
+/**
+ * @brief Mesure les ventes d'un grossiste à des acheteurs concurrents, chacun son type d'objet
+ *        ou une commande groupée de trois lignes
+ */
+template<typename W>
+void measureWholesale(const char* variant, int nbThreads, int uniqueId) {
+    std::uint64_t nbOperations = std::uint64_t(nbThreads) * TRADE_ITERATIONS;
+
+    W wholesale(uniqueId, 0);
+    for (ItemType item : spreadItems) {
+        wholesale.fill(item, int(nbOperations));
+    }
+    double ns = measureParallelNsPerOp(nbThreads, TRADE_ITERATIONS, [&](int t) {
+        doNotOptimize(wholesale.trade(spreadItems[t % 6], 1));
+    });
+    printResult("trade", std::string(variant) + "_spread_items", nbThreads, nbOperations, ns);
+
+    W batchWholesale(uniqueId + 1, 0);
+    for (ItemType item : spreadItems) {
+        batchWholesale.fill(item, int(nbOperations));
+    }
+    ns = measureParallelNsPerOp(nbThreads, TRADE_ITERATIONS, [&](int) {
+        Order order;
+        order.add(ItemType::Sand, 1);
+        order.add(ItemType::Copper, 1);
+        order.add(ItemType::Petrol, 1);
+        doNotOptimize(batchWholesale.tradeBatch(order, BatchMode::BestEffort));
+    });
+    printResult("trade", std::string(variant) + "_batch_3_lines", nbThreads, nbOperations, ns);
+}
+
+} // namespace
+
+void runTradeBenchmarks() {
+    for (int nbThreads : threadCounts) {
+        std::uint64_t nbOperations = std::uint64_t(nbThreads) * TRADE_ITERATIONS;
+
+        /* Tous les acheteurs se disputent le même compteur */
+        BenchExtractor extractor(0, 0);
+        extractor.fill(int(nbOperations));
+        double ns = measureParallelNsPerOp(nbThreads, TRADE_ITERATIONS, [&](int) {
+            doNotOptimize(extractor.trade(ItemType::Sand, 1));
+        });
+        printResult("trade", "extractor_same_item", nbThreads, nbOperations, ns);
+
+        /* Stock épuisé : chaque appel échoue sans rien modifier */
+        ns = measureParallelNsPerOp(nbThreads, TRADE_ITERATIONS, [&](int) {
+            doNotOptimize(extractor.trade(ItemType::Sand, 1));
+        });
+        printResult("trade", "extractor_out_of_stock", nbThreads, nbOperations, ns);
+
+        /* Les acheteurs jouent le rôle des usines qui se fournissent chez le même grossiste */
+        measureWholesale<BenchWholesale>("wholesale", nbThreads, 1);
+        measureWholesale<BenchShardedWholesale>("sharded_wholesale", nbThreads, 3);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Nombre d'allocations sur le tas depuis le lancement, tous threads confondus
+ *        (operator new remplacé par les bancs d'essai)
+ */
+std::uint64_t getNbAllocations();
+
+// Allocations faites pendant la dernière mesure, affichées puis remises à zéro par printResult
+inline std::uint64_t measuredAllocations = 0;
+
+/**
+ * @brief Empêche le compilateur d'éliminer un calcul dont le résultat n'est pas utilisé
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Mesure le temps moyen d'une opération
+ * @param iterations Nombre de répétitions de l'opération
+ * @param operation L'opération à mesurer
+ * @return Le temps moyen par opération, en nanosecondes
+ */
+template<typename Operation>
+double measureNsPerOp(std::uint64_t iterations, Operation&& operation) {
+    std::uint64_t allocations = getNbAllocations();
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i) {
+        operation();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    measuredAllocations = getNbAllocations() - allocations;
+    return elapsed.count() / double(iterations);
+}
+
+/**
+ * @brief Mesure une opération exécutée en même temps par plusieurs threads
+ * @param nbThreads Nombre de threads, lancés ensemble
+ * @param iterationsPerThread Nombre de répétitions par thread
+ * @param operation L'opération, appelée avec l'indice du thread
+ * @return Le temps écoulé divisé par le nombre total d'opérations, en nanosecondes
+ */
+template<typename Operation>
+double measureParallelNsPerOp(int nbThreads, std::uint64_t iterationsPerThread, Operation&& operation) {
+    std::atomic<int> nbReady{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < nbThreads; ++t) {
+        threads.emplace_back([&, t] {
+            ++nbReady;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (std::uint64_t i = 0; i < iterationsPerThread; ++i) {
+                operation(t);
+            }
+        });
+    }
+
+    while (nbReady.load() < nbThreads) {
+        std::this_thread::yield();
+    }
+    /* La création des threads n'est pas comptée */
+    std::uint64_t allocations = getNbAllocations();
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    measuredAllocations = getNbAllocations() - allocations;
+    return elapsed.count() / double(iterationsPerThread * std::uint64_t(nbThreads));
+}
+
+/**
+ * @brief Affiche un résultat sur une ligne, dans un format stable d'un commit à l'autre :
+ *        `suite;bench;threads;operations;ns/op;allocs/op`, les allocations étant celles
+ *        de la dernière mesure (measuredAllocations)
+ */
+void printResult(const std::string& suite, const std::string& name, int nbThreads,
+                 std::uint64_t nbOperations, double nsPerOp);
+
+// Suites de bancs d'essai, une par fichier bench_*.cpp
+void runRandomBenchmarks();
+void runTradeBenchmarks();
+void runSellerBenchmarks();
+void runEconomyBenchmarks();
+
+#endif // BENCHMARK_H
@@ -0,0 +1,116 @@
+/**
+ * @file main.cpp
+ * @brief Point d'entrée des bancs d'essai du laboratoire 3.
+ *
+ * Usage : Lab3_Benchmarks [suite...]
+ * Sans argument, toutes les suites sont exécutées : random, seller, trade (micro-bancs)
+ * et economy (économies entières de taille croissante).
+ * Chaque résultat donne aussi le nombre moyen d'allocations sur le tas par opération,
+ * compté par le remplacement d'operator new ci-dessous.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include "benchmark.h"
+#include "extractor.h"
+#include "factory.h"
+#include "headlessinterface.h"
+#include "wholesale.h"
+
+namespace {
+
+struct Suite {
+    const char* name;
+    void (*run)();
+};
+
+const Suite suites[] = {
+    {"random", runRandomBenchmarks},
+    {"seller", runSellerBenchmarks},
+    {"trade", runTradeBenchmarks},
+    {"economy", runEconomyBenchmarks},
+};
+
+// Allocations sur le tas depuis le lancement
+std::atomic<std::uint64_t> nbAllocations{0};
+
+void* countedAllocate(std::size_t size, std::size_t alignment) {
+    nbAllocations.fetch_add(1, std::memory_order_relaxed);
+    size = size ? size : 1;
+    void* block = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+} // namespace
+
+/* Remplacement global : toute la simulation passe par le compteur */
+void* operator new(std::size_t size) {
+    return countedAllocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return countedAllocate(size, std::size_t(alignment));
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept {
+    std::free(block);
+}
+
+std::uint64_t getNbAllocations() {
+    return nbAllocations.load(std::memory_order_relaxed);
+}
+
+void printResult(const std::string& suite, const std::string& name, int nbThreads,
+                 std::uint64_t nbOperations, double nsPerOp) {
+    double allocationsPerOp = nbOperations ? double(measuredAllocations) / double(nbOperations) : 0.0;
+    measuredAllocations = 0;
+    std::cout << suite << ";" << name << ";" << nbThreads << ";" << nbOperations << ";"
+              << std::fixed << std::setprecision(2) << nsPerOp << ";"
+              << std::setprecision(3) << allocationsPerOp << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    /* Les vendeurs signalent leurs changements à une interface sans affichage */
+    HeadlessInterface interface;
+    Extractor::setInterface(&interface);
+    Factory::setInterface(&interface);
+    Wholesale::setInterface(&interface);
+
+    std::cout << "suite;bench;threads;operations;ns/op;allocs/op" << std::endl;
+
+    for (const Suite& suite : suites) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; ++i) {
+            selected = selected || !std::strcmp(argv[i], suite.name);
+        }
+        if (selected) {
+            suite.run();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file coroutinescheduler.cpp
+ * @brief Exécution des routines des vendeurs comme coroutines sur un seul thread.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "coroutinescheduler.h"
+#include "seller.h"
+#include <pcosynchro/pcothread.h>
+
+namespace {
+// Vrai sur le thread qui exécute CoroutineScheduler::run
+thread_local bool onSchedulerThread = false;
+}
+
+std::atomic<std::size_t> CoroutineScheduler::frameBytes{0};
+
+void* CoroutineScheduler::Routine::promise_type::operator new(std::size_t size) {
+    frameBytes += size;
+    return ::operator new(size);
+}
+
+void CoroutineScheduler::Routine::promise_type::operator delete(void* frame, std::size_t size) {
+    frameBytes -= size;
+    ::operator delete(frame);
+}
+
+CoroutineScheduler::CoroutineScheduler(SimulationClock* clock) : clock(clock) {}
+
+CoroutineScheduler::~CoroutineScheduler() {
+    for (auto& task : tasks) {
+        if (task->routine.handle) {
+            task->routine.handle.destroy();
+        }
+    }
+}
+
+void CoroutineScheduler::addSeller(Seller* seller) {
+    tasks.push_back(std::make_unique<Task>(this, seller));
+    seller->getWakeup().setListener(tasks.back().get());
+}
+
+CoroutineScheduler::Routine CoroutineScheduler::routine(Task* task) {
+    for (;;) {
+        FastClock::setThreadTimeline(&task->simulatedTime);
+        Step next = task->seller->advance();
+        ++nbSteps;
+
+        if (next.kind == Step::Kind::Sleep) {
+            std::uint64_t realUs = clock->elapse(next.delayUs);
+            FastClock::setThreadTimeline(nullptr);
+            co_await SleepAwaiter{task, realUs};
+        } else {
+            FastClock::setThreadTimeline(nullptr);
+            co_await WakeupAwaiter{task};
+        }
+    }
+}
+
+void CoroutineScheduler::SleepAwaiter::await_suspend(std::coroutine_handle<>) const {
+    CoroutineScheduler* scheduler = task->scheduler;
+    if (realUs == 0) {
+        /* Pause gratuite : la routine passe après les autres */
+        scheduler->ready.push_back(task);
+        return;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(realUs);
+    scheduler->timers.push({deadline, scheduler->nextSequence++, task});
+}
+
+bool CoroutineScheduler::WakeupAwaiter::await_ready() const {
+    /* Signal arrivé pendant l'étape : pas besoin de suspendre */
+    return task->seller->getWakeup().tryConsume();
+}
+
+void CoroutineScheduler::WakeupAwaiter::await_suspend(std::coroutine_handle<>) const {
+    task->parked = true;
+    /* Un signal émis entre await_ready et la mise en attente n'a pas vu `parked` */
+    bool expected = true;
+    if (task->seller->getWakeup().tryConsume() && task->parked.compare_exchange_strong(expected, false)) {
+        task->scheduler->push(task);
+    }
+}
+
+void CoroutineScheduler::Task::onSignal(Wakeup* wakeup) {
+    bool expected = true;
+    if (parked.compare_exchange_strong(expected, false)) {
+        wakeup->tryConsume();
+        scheduler->push(this);
+    }
+}
+
+void CoroutineScheduler::push(Task* task) {
+    if (onSchedulerThread) {
+        ready.push_back(task);
+        return;
+    }
+
+    incomingMutex.lock(); // Début S.C.
+    incoming.push_back(task);
+    hasIncoming = true;
+    incomingMutex.unlock(); // Fin S.C.
+}
+
+void CoroutineScheduler::run() {
+    onSchedulerThread = true;
+    std::vector<Task*> started;
+
+    for (auto& task : tasks) {
+        if (task->seller->start()) {
+            task->routine = routine(task.get());
+            ready.push_back(task.get());
+            started.push_back(task.get());
+        }
+    }
+    nbRoutines = started.size();
+
+    std::vector<Task*> woken;
+    while (!stopping.load()) {
+        if (hasIncoming.load()) {
+            incomingMutex.lock(); // Début S.C.
+            woken.swap(incoming);
+            hasIncoming = false;
+            incomingMutex.unlock(); // Fin S.C.
+            ready.insert(ready.end(), woken.begin(), woken.end());
+            woken.clear();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        while (!timers.empty() && timers.top().deadline <= now) {
+            ready.push_back(timers.top().task);
+            timers.pop();
+        }
+
+        if (!ready.empty()) {
+            Task* task = ready.front();
+            ready.pop_front();
+            task->routine.handle.resume();
+            continue;
+        }
+
+        /* Rien de prêt : attente de la prochaine échéance ou d'un réveil venu d'un autre thread */
+        std::uint64_t waitUs = COROUTINE_IDLE_US;
+        if (!timers.empty()) {
+            auto untilNext = std::chrono::duration_cast<std::chrono::microseconds>(timers.top().deadline - now).count();
+            waitUs = std::min<std::uint64_t>(waitUs, std::uint64_t(untilNext));
+        }
+        PcoThread::usleep(waitUs);
+    }
+
+    for (Task* task : started) {
+        task->seller->finish();
+    }
+    onSchedulerThread = false;
+}
+
+void CoroutineScheduler::stop() {
+    stopping = true;
+}
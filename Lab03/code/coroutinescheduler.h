@@ -0,0 +1,179 @@
+/**
+ * @file coroutinescheduler.h
+ * @brief Routines des vendeurs en coroutines C++20, multiplexées sur un seul thread.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef COROUTINESCHEDULER_H
+#define COROUTINESCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include "restocknotifier.h"
+#include "simulationclock.h"
+
+class Seller;
+
+// Attente maximale du thread lorsqu'aucune routine n'est prête, en microsecondes
+#define COROUTINE_IDLE_US 1000
+
+/**
+ * @brief Exécuteur à coroutines : un seul thread pour tous les vendeurs.
+ *
+ * La routine de chaque vendeur est une coroutine sans pile propre, dont seul l'état
+ * (quelques centaines d'octets) est alloué. Elle enchaîne les étapes du vendeur
+ * (Seller::advance) et suspend sur `co_await` : un minuteur pour une pause, son
+ * évènement de réveil pour une attente. Le thread reprend tour à tour les routines
+ * prêtes ; les signaux de réveil, venus de ce thread ou d'un autre (place de marché),
+ * remettent la routine en file.
+ */
+class CoroutineScheduler
+{
+public:
+    /**
+     * @param clock Horloge qui convertit les pauses simulées en temps réel
+     */
+    explicit CoroutineScheduler(SimulationClock* clock);
+
+    ~CoroutineScheduler();
+
+    /**
+     * @brief Confie un vendeur à l'exécuteur. À appeler avant run().
+     * @param seller Le vendeur, dont les signaux de réveil sont redirigés vers l'exécuteur
+     */
+    void addSeller(Seller* seller);
+
+    /**
+     * @brief Démarre les routines et les reprend jusqu'à l'appel de stop()
+     */
+    void run();
+
+    /**
+     * @brief Demande l'arrêt de l'exécuteur
+     */
+    void stop();
+
+    /**
+     * @brief Nombre d'étapes exécutées depuis le lancement
+     */
+    std::uint64_t getNbSteps() const { return nbSteps.load(); }
+
+    std::size_t getNbRoutines() const { return nbRoutines; }
+
+    /**
+     * @brief Mémoire allouée pour l'état de toutes les coroutines, en octets
+     */
+    std::size_t getFrameBytes() const { return frameBytes; }
+
+private:
+    struct Task;
+
+    /**
+     * @brief Coroutine d'un vendeur, suspendue dès sa création et détruite par l'exécuteur
+     */
+    struct Routine {
+        struct promise_type {
+            Routine get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+
+            // L'état de chaque coroutine est compté dans getFrameBytes()
+            static void* operator new(std::size_t size);
+            static void operator delete(void* frame, std::size_t size);
+        };
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    /**
+     * @brief Suspension jusqu'à l'échéance d'une pause
+     */
+    struct SleepAwaiter {
+        Task* task;
+        std::uint64_t realUs;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const;
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Suspension jusqu'au prochain signal de l'évènement de réveil du vendeur
+     */
+    struct WakeupAwaiter {
+        Task* task;
+
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<>) const;
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Un vendeur et sa routine
+     */
+    struct Task : public WakeupListener {
+        CoroutineScheduler* scheduler;
+        Seller* seller;
+        Routine routine{};
+        // La routine attend un signal de réveil et n'est dans aucune file
+        std::atomic<bool> parked{false};
+        // Temps simulé propre à la routine, avancé par ses pauses avec FastClock
+        std::uint64_t simulatedTime = 0;
+
+        Task(CoroutineScheduler* scheduler, Seller* seller) : scheduler(scheduler), seller(seller) {}
+
+        void onSignal(Wakeup* wakeup) override;
+    };
+
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        std::uint64_t sequence;
+        Task* task;
+
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * @brief La routine d'un vendeur : ses étapes, séparées par des co_await
+     */
+    Routine routine(Task* task);
+
+    /**
+     * @brief Remet une routine en file, depuis n'importe quel thread
+     */
+    void push(Task* task);
+
+    SimulationClock* clock;
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::size_t nbRoutines = 0;
+
+    // Routines prêtes, manipulées par le seul thread de l'exécuteur
+    std::deque<Task*> ready;
+    // Routines réveillées depuis un autre thread, reprises au tour suivant
+    PcoMutex incomingMutex;
+    std::vector<Task*> incoming;
+    std::atomic<bool> hasIncoming{false};
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::uint64_t nextSequence = 0;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> nbSteps{0};
+
+    static std::atomic<std::size_t> frameBytes;
+};
+
+#endif // COROUTINESCHEDULER_H
@@ -0,0 +1,92 @@
+/**
+ * @file discreteeventengine.cpp
+ * @brief Exécution de tous les vendeurs par un unique thread, dans l'ordre du temps simulé.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "discreteeventengine.h"
+#include "seller.h"
+
+void DiscreteEventEngine::addSeller(Seller* seller) {
+    tasks.push_back(std::make_unique<Task>(this, seller));
+    seller->getWakeup().setListener(tasks.back().get());
+}
+
+void DiscreteEventEngine::schedule(Task* task, std::uint64_t time) {
+    events.push({time, nextSequence++, task});
+    cond.notifyOne();
+}
+
+void DiscreteEventEngine::Task::onSignal(Wakeup* wakeup) {
+    engine->mutex.lock(); // Début S.C.
+    if (parked && wakeup->tryConsume()) {
+        parked = false;
+        engine->schedule(this, engine->currentTime.load());
+    }
+    engine->mutex.unlock(); // Fin S.C.
+}
+
+void DiscreteEventEngine::run() {
+    std::vector<Task*> started;
+
+    for (auto& task : tasks) {
+        if (task->seller->start()) {
+            started.push_back(task.get());
+        }
+    }
+
+    mutex.lock(); // Début S.C.
+    for (Task* task : started) {
+        schedule(task, 0);
+    }
+    mutex.unlock(); // Fin S.C.
+
+    while (true) {
+        mutex.lock(); // Début S.C.
+        /* Tous les vendeurs attendent : seul un autre thread (place de marché) peut en réveiller un */
+        while (events.empty() && !stopping) {
+            cond.wait(&mutex);
+        }
+        if (stopping || (timeLimit && events.top().time > timeLimit)) {
+            mutex.unlock(); // Fin S.C.
+            break;
+        }
+        Event event = events.top();
+        events.pop();
+        currentTime = event.time;
+        mutex.unlock(); // Fin S.C.
+
+        /* L'étape s'exécute hors de la section critique : elle peut signaler des réveils */
+        Step next = event.task->seller->advance();
+        ++nbEvents;
+
+        mutex.lock(); // Début S.C.
+        if (next.kind == Step::Kind::Sleep) {
+            schedule(event.task, event.time + next.delayUs);
+        } else if (event.task->seller->getWakeup().tryConsume()) {
+            /* Signal reçu pendant l'étape : pas d'attente */
+            schedule(event.task, event.time);
+        } else {
+            event.task->parked = true;
+        }
+        mutex.unlock(); // Fin S.C.
+    }
+
+    for (Task* task : started) {
+        task->seller->finish();
+    }
+}
+
+void DiscreteEventEngine::stop() {
+    mutex.lock(); // Début S.C.
+    stopping = true;
+    cond.notifyAll();
+    mutex.unlock(); // Fin S.C.
+}
+
+void DiscreteEventEngine::sleep(std::uint64_t) {}
+
+std::uint64_t DiscreteEventEngine::elapse(std::uint64_t) {
+    return 0;
+}
@@ -0,0 +1,111 @@
+#ifndef DISCRETEEVENTENGINE_H
+#define DISCRETEEVENTENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+#include "restocknotifier.h"
+#include "simulationclock.h"
+
+class Seller;
+
+/**
+ * @brief Ordonnanceur à évènements discrets : alternative au thread par vendeur.
+ *
+ * Un seul thread exécute les étapes (Seller::step) de tous les vendeurs, dans l'ordre de
+ * leur date simulée. Une pause ne coûte qu'une insertion dans l'échéancier ; un vendeur
+ * qui attend un réveil n'y figure plus et n'est remis en file que lorsque son évènement
+ * de réveil est signalé (vente, réassort, livraison). Le nombre de vendeurs n'est donc
+ * plus limité par le nombre de threads du système.
+ *
+ * L'ordonnanceur est aussi l'horloge de la simulation : le temps simulé est celui du
+ * dernier évènement exécuté, indépendamment du temps réel.
+ */
+class DiscreteEventEngine : public SimulationClock
+{
+public:
+    /**
+     * @brief Confie un vendeur à l'ordonnanceur. À appeler avant run().
+     * @param seller Le vendeur, dont les signaux de réveil sont redirigés vers l'ordonnanceur
+     */
+    void addSeller(Seller* seller);
+
+    /**
+     * @brief Borne la durée simulée ; l'ordonnanceur s'arrête seul une fois atteinte
+     * @param simulatedUs Durée simulée en microsecondes, 0 pour ne pas borner
+     */
+    void setTimeLimit(std::uint64_t simulatedUs) { timeLimit = simulatedUs; }
+
+    /**
+     * @brief Routine du thread de l'ordonnanceur, jusqu'à l'appel de stop() ou la durée limite
+     */
+    void run();
+
+    /**
+     * @brief Demande l'arrêt de l'ordonnanceur
+     */
+    void stop();
+
+    /**
+     * @brief Nombre d'étapes exécutées depuis le lancement
+     */
+    std::uint64_t getNbEvents() const { return nbEvents.load(); }
+
+    /**
+     * @brief Les vendeurs ne dorment pas sous l'ordonnanceur : leurs pauses sont des évènements
+     */
+    void sleep(std::uint64_t simulatedUs) override;
+    std::uint64_t elapse(std::uint64_t simulatedUs) override;
+
+    std::uint64_t now() override { return currentTime.load(); }
+
+private:
+    /**
+     * @brief Un vendeur vu par l'ordonnanceur
+     */
+    struct Task : public WakeupListener {
+        DiscreteEventEngine* engine;
+        Seller* seller;
+        // Le vendeur attend un signal de réveil et n'est pas dans l'échéancier
+        bool parked = false;
+
+        Task(DiscreteEventEngine* engine, Seller* seller) : engine(engine), seller(seller) {}
+
+        void onSignal(Wakeup* wakeup) override;
+    };
+
+    struct Event {
+        std::uint64_t time;
+        // Départage les évènements simultanés dans l'ordre de leur programmation
+        std::uint64_t sequence;
+        Task* task;
+
+        bool operator>(const Event& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * @brief Programme l'étape suivante d'une tâche (mutex tenu)
+     */
+    void schedule(Task* task, std::uint64_t time);
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    std::uint64_t nextSequence = 0;
+    std::uint64_t timeLimit = 0;
+
+    std::atomic<std::uint64_t> currentTime{0};
+    std::atomic<std::uint64_t> nbEvents{0};
+
+    bool stopping = false;
+    PcoMutex mutex;
+    PcoConditionVariable cond;
+};
+
+#endif // DISCRETEEVENTENGINE_H
@@ -281,27 +281,27 @@ void Display::set_link(int from, int to){
     }
 }
 
-void Display::update_stocks(int idx, std::map<ItemType, int>* stocks) {
+void Display::update_stocks(int idx, const ItemsForSale& stocks) {
 
     std::vector<bool> updates = resourceAssociations[idx];
 
     if(updates[0]){
-        this->petrols[idx]->setText(QString::number((*stocks)[ItemType::Petrol]));
+        this->petrols[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Petrol)]));
     }
     if(updates[1]){
-        this->coppers[idx]->setText(QString::number((*stocks)[ItemType::Copper]));
+        this->coppers[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Copper)]));
     }
     if(updates[2]){
-        this->chips[idx]->setText(QString::number((*stocks)[ItemType::Chip]));
+        this->chips[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Chip)]));
     }
     if(updates[3]){
-        this->sands[idx]->setText(QString::number((*stocks)[ItemType::Sand]));
+        this->sands[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Sand)]));
     }
     if(updates[4]){
-        this->robots[idx]->setText(QString::number((*stocks)[ItemType::Robot]));
+        this->robots[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Robot)]));
     }
     if(updates[5]){
-        this->plastics[idx]->setText(QString::number((*stocks)[ItemType::Plastic]));
+        this->plastics[idx]->setText(QString::number(stocks[static_cast<std::size_t>(ItemType::Plastic)]));
     }
 
 }
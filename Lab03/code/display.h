@@ -69,7 +69,7 @@ public:
     std::vector<ProductionItem*> m_productItem;
 
 
-    void update_stocks(int idx, std::map<ItemType, int>* stocks);
+    void update_stocks(int idx, const ItemsForSale& stocks);
     void update_fund(int idx, QString fund);
 
     void set_link(int from, int to);
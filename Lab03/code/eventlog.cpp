@@ -0,0 +1,179 @@
+/**
+ * @file eventlog.cpp
+ * @brief Enregistrement des évènements par tampons de thread et rejeu du journal.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "eventlog.h"
+#include "simulationclock.h"
+#include "utils.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+std::atomic<EventLog*> EventLog::active{nullptr};
+std::atomic<std::uint64_t> EventLog::nbGenerations{0};
+
+EventLog::EventLog(const std::string& path, const EventLogHeader& header, SimulationClock* clock)
+    : clock(clock), generation(++nbGenerations), file(path, std::ios::binary | std::ios::trunc)
+{
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void EventLog::setActive(EventLog* log) {
+    active.store(log, std::memory_order_release);
+}
+
+EventLog::ThreadBuffer& EventLog::localBuffer() {
+    thread_local std::uint64_t ownerGeneration = 0;
+    thread_local ThreadBuffer* buffer = nullptr;
+
+    if (ownerGeneration != generation) {
+        /* Premier évènement de ce thread pour ce journal */
+        mutex.lock();
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        mutex.unlock();
+        buffer->records.reserve(EVENTLOG_BUFFER_RECORDS);
+        ownerGeneration = generation;
+    }
+    return *buffer;
+}
+
+void EventLog::append(EventKind kind, int seller, int counterparty, ItemType item, int qty, int amount) {
+    ThreadBuffer& buffer = localBuffer();
+    buffer.records.push_back({sequence.fetch_add(1, std::memory_order_relaxed), clock->now(),
+                              seller, counterparty, qty, amount, kind, static_cast<std::uint8_t>(item)});
+
+    if (buffer.records.size() >= EVENTLOG_BUFFER_RECORDS) {
+        mutex.lock();
+        writeRecords(buffer);
+        mutex.unlock();
+    }
+}
+
+void EventLog::writeRecords(ThreadBuffer& buffer) {
+    file.write(reinterpret_cast<const char*>(buffer.records.data()),
+               std::streamsize(buffer.records.size() * sizeof(EventRecord)));
+    buffer.records.clear();
+}
+
+bool EventLog::close() {
+    EventLog* self = this;
+    active.compare_exchange_strong(self, nullptr);
+
+    mutex.lock();
+    for (auto& buffer : buffers) {
+        writeRecords(*buffer);
+    }
+    file.close();
+    mutex.unlock();
+
+    return !file.fail();
+}
+
+ReplayResult replayEventLog(const std::string& path) {
+    ReplayResult result;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open event log " << path << std::endl;
+        return result;
+    }
+
+    EventLogHeader& header = result.header;
+    const EventLogHeader expected;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || std::memcmp(header.magic, expected.magic, sizeof(header.magic)) || header.version != expected.version) {
+        std::cerr << path << ": not an event log of version " << EVENTLOG_VERSION << std::endl;
+        return result;
+    }
+
+    int nbSellers = int(header.nbExtractors + header.nbFactories + header.nbWholesalers);
+    std::vector<EventRecord> records;
+    EventRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        bool twoSellers = record.kind == EventKind::Sale || record.kind == EventKind::Fill;
+        if (record.seller < 0 || record.seller >= nbSellers || record.item > NB_ITEM_TYPES ||
+            (twoSellers && (record.counterparty < 0 || record.counterparty >= nbSellers))) {
+            std::cerr << path << ": invalid event " << record.sequence << std::endl;
+            return result;
+        }
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(), [](const EventRecord& a, const EventRecord& b) {
+        return a.sequence < b.sequence;
+    });
+
+    /* Mêmes identifiants que ceux attribués par Utils */
+    int nbExtractors = int(header.nbExtractors);
+    int nbWholesalers = int(header.nbWholesalers);
+    SellerArena arena;
+    std::vector<Extractor*> extractors = createExtractors(arena, nbExtractors, 0);
+    std::vector<Wholesale*> wholesalers = createWholesaler(arena, nbWholesalers, nbExtractors);
+    std::vector<Factory*> factories = createFactories(arena, int(header.nbFactories), nbExtractors + nbWholesalers);
+
+    std::vector<Seller*> sellers(extractors.begin(), extractors.end());
+    sellers.insert(sellers.end(), wholesalers.begin(), wholesalers.end());
+    sellers.insert(sellers.end(), factories.begin(), factories.end());
+
+    long long wages = 0;
+    long long escrow = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const EventRecord& event : records) {
+        Seller* seller = sellers[event.seller];
+        ItemType item = static_cast<ItemType>(event.item);
+
+        switch (event.kind) {
+            case EventKind::Extract:
+            case EventKind::Build:
+                seller->applyReplayed(-event.amount, item, event.qty);
+                wages += event.amount;
+                break;
+            case EventKind::Consume:
+                seller->applyReplayed(0, item, -event.qty);
+                break;
+            case EventKind::Sale:
+                seller->applyReplayed(event.amount, item, -event.qty);
+                sellers[event.counterparty]->applyReplayed(-event.amount, item, event.qty);
+                break;
+            case EventKind::Bid:
+                seller->applyReplayed(-event.amount, ItemType::Nothing, 0);
+                escrow += event.amount;
+                break;
+            case EventKind::Fill:
+                seller->applyReplayed(event.amount, item, -event.qty);
+                sellers[event.counterparty]->applyReplayed(0, item, event.qty);
+                escrow -= event.amount;
+                break;
+            case EventKind::Refund:
+                seller->applyReplayed(event.amount, ItemType::Nothing, 0);
+                escrow -= event.amount;
+                break;
+            case EventKind::FinalFund:
+                result.nbMismatches += seller->getFund() != event.amount;
+                break;
+            case EventKind::FinalStock:
+                result.nbMismatches += seller->getStock(item) != event.qty;
+                break;
+        }
+        result.lastTimeUs = std::max(result.lastTimeUs, event.timeUs);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+    result.nbEvents = records.size();
+
+    result.startFund = static_cast<long long>(header.nbExtractors) * EXTRACTOR_FUND +
+                       static_cast<long long>(header.nbFactories) * FACTORIES_FUND +
+                       static_cast<long long>(header.nbWholesalers) * WHOLESALERS_FUND;
+    result.endFund = wages + escrow;
+    for (Seller* seller : sellers) {
+        result.endFund += seller->getFund();
+    }
+
+    result.loaded = true;
+    return result;
+}
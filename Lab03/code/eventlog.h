@@ -0,0 +1,174 @@
+/**
+ * @file eventlog.h
+ * @brief Journal binaire des échanges, assemblages et extractions d'une simulation, et son rejeu.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include "itemtype.h"
+
+class SimulationClock;
+
+// Nombre d'évènements accumulés par thread avant d'être écrits dans le fichier
+#define EVENTLOG_BUFFER_RECORDS 4096
+// Version du format, à incrémenter à chaque changement de EventRecord ou EventLogHeader
+#define EVENTLOG_VERSION 1
+
+/**
+ * @brief Nature d'un évènement du journal et effet de son rejeu
+ */
+enum class EventKind : std::uint8_t {
+    Extract,    // Mine : salaire `amount` versé, `qty` ressources en stock
+    Consume,    // Usine : `qty` ressources consommées par un assemblage
+    Build,      // Usine : salaires `amount` versés, `qty` objets en stock
+    Sale,       // Vente directe de `qty` objets de `seller` à `counterparty` pour `amount`
+    Bid,        // Offre d'achat : `amount` passe des fonds de `seller` au séquestre
+    Fill,       // Place de marché : `seller` livre `qty` objets à `counterparty`, payé `amount` par le séquestre
+    Refund,     // Place de marché : `amount` rendu du séquestre à `seller`
+    FinalFund,  // Fonds `amount` de `seller` à la fin de l'enregistrement
+    FinalStock  // Stock `qty` de `seller` à la fin de l'enregistrement
+};
+
+/**
+ * @brief Évènement de taille fixe, écrit tel quel (ordre des octets de la machine)
+ */
+struct EventRecord {
+    // Ordre global des évènements, les tampons des threads étant écrits dans le désordre
+    std::uint64_t sequence;
+    // Temps simulé (µs)
+    std::uint64_t timeUs;
+    std::int32_t seller;
+    std::int32_t counterparty;
+    std::int32_t qty;
+    std::int32_t amount;
+    EventKind kind;
+    std::uint8_t item;
+    // Octets de bourrage mis à zéro, pour qu'une même simulation donne le même fichier
+    std::uint8_t reserved[6] = {};
+};
+
+static_assert(sizeof(EventRecord) == 40, "EventRecord is written as is, its size is part of the format");
+
+/**
+ * @brief En-tête du journal : de quoi recréer les vendeurs et relancer la même simulation
+ */
+struct EventLogHeader {
+    char magic[8] = {'L', 'A', 'B', '3', 'E', 'V', 'T', '\0'};
+    std::uint32_t version = EVENTLOG_VERSION;
+    std::uint32_t nbExtractors = 0;
+    std::uint32_t nbFactories = 0;
+    std::uint32_t nbWholesalers = 0;
+    std::uint64_t seed = 0;
+};
+
+/**
+ * @brief Enregistreur des évènements de la simulation.
+ *
+ * Chaque thread accumule ses évènements dans son propre tampon, écrit dans le fichier
+ * sous verrou une fois plein ; le seul point commun aux threads est le compteur de
+ * séquence. Les vendeurs appellent `EventLog::record`, sans effet si aucun journal
+ * n'est actif.
+ */
+class EventLog
+{
+public:
+    /**
+     * @param path Le fichier à écrire
+     * @param header L'en-tête, écrit aussitôt
+     * @param clock L'horloge qui date les évènements
+     */
+    EventLog(const std::string& path, const EventLogHeader& header, SimulationClock* clock);
+
+    bool isOpen() const { return bool(file); }
+
+    /**
+     * @brief Active ou désactive (nullptr) le journal qui reçoit les évènements
+     */
+    static void setActive(EventLog* log);
+
+    /**
+     * @brief Ajoute un évènement au journal actif
+     */
+    static void record(EventKind kind, int seller, int counterparty, ItemType item, int qty, int amount) {
+        EventLog* log = active.load(std::memory_order_acquire);
+        if (log) {
+            log->append(kind, seller, counterparty, item, qty, amount);
+        }
+    }
+
+    /**
+     * @brief Écrit les tampons de tous les threads et ferme le fichier.
+     *        À appeler une fois tous les vendeurs arrêtés.
+     * @return false si une écriture a échoué
+     */
+    bool close();
+
+    std::uint64_t getNbRecords() const { return sequence.load(); }
+
+private:
+    struct ThreadBuffer {
+        std::vector<EventRecord> records;
+    };
+
+    void append(EventKind kind, int seller, int counterparty, ItemType item, int qty, int amount);
+
+    ThreadBuffer& localBuffer();
+
+    /**
+     * @brief Écrit le contenu du tampon dans le fichier et le vide, verrou déjà pris
+     */
+    void writeRecords(ThreadBuffer& buffer);
+
+    SimulationClock* clock;
+    // Distingue ce journal d'un précédent dans les tampons des threads
+    const std::uint64_t generation;
+    std::atomic<std::uint64_t> sequence{0};
+
+    PcoMutex mutex;
+    std::ofstream file;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    static std::atomic<EventLog*> active;
+    static std::atomic<std::uint64_t> nbGenerations;
+};
+
+/**
+ * @brief Bilan du rejeu d'un journal
+ */
+struct ReplayResult {
+    bool loaded = false;
+    EventLogHeader header;
+    std::uint64_t nbEvents = 0;
+    // Temps simulé du dernier évènement (µs)
+    std::uint64_t lastTimeUs = 0;
+    double seconds = 0.0;
+    // Fonds et stocks finaux qui diffèrent de ceux enregistrés
+    std::uint64_t nbMismatches = 0;
+    long long startFund = 0;
+    // Fonds + salaires + séquestre après le rejeu
+    long long endFund = 0;
+};
+
+/**
+ * @brief Recrée les vendeurs décrits par l'en-tête et leur applique, au plus vite et dans
+ *        l'ordre de séquence, tous les évènements du journal.
+ *
+ * Les fonds et stocks obtenus sont comparés à ceux enregistrés à la fin de la simulation.
+ * L'interface des vendeurs doit être choisie avant l'appel.
+ *
+ * @param path Le journal à rejouer
+ * @return Le bilan, `loaded` à false si le fichier est illisible (message sur std::cerr)
+ */
+ReplayResult replayEventLog(const std::string& path);
+
+#endif // EVENTLOG_H
@@ -10,86 +10,138 @@
  *   pour protéger les ressources partagées en utilisant un mutex.
  * - Intégration d'une condition d'arrêt propre dans la méthode `run` pour permettre
  *   une terminaison gracieuse du thread.
+ * - Remplacement du mutex par des compteurs atomiques : stocks réservés par
+ *   compare-and-swap dans `trade`, salaire débité via `tryPay` dans `run`.
+ * - Une mine sans le sou attend d'être réveillée par une vente au lieu de sonder.
+ * - En mode place de marché, chaque ressource minée est mise en vente dans le carnet d'ordres.
+ * - Temps de minage tiré du générateur par thread (ThreadRandom) au lieu de `rand()`.
+ * - Les pauses passent par l'horloge de simulation injectée (Seller::setClock).
+ * - La routine est découpée en étapes non bloquantes (`step`) pour pouvoir être
+ *   exécutée par l'ordonnanceur à évènements discrets ; le mineur est compté dès qu'il est payé.
+ * - `trade` compte chaque demande selon son issue dans les statistiques du vendeur.
+ * - Versement du salaire encadré comme transfert pour l'audit des fonds ; compteur atomique.
+ * - Prix, salaire et temps de minage lus dans le catalogue chargé au démarrage (RecipeBook).
+ * - Chaque ressource minée est inscrite au journal d'évènements.
+ * - Messages des échanges passés à l'interface sous forme binaire (`logTransaction`), sans mise en texte.
+ * - Ressources minées comptées comme offre par la tarification dynamique ; prix lu une fois par vente.
  */
 
 #include "extractor.h"
-#include "costs.h"
-#include <pcosynchro/pcothread.h>
+#include "eventlog.h"
+#include "pricingengine.h"
+#include "marketplace.h"
+#include "moneyledger.h"
+#include "threadrandom.h"
+#include <cassert>
 
-WindowInterface* Extractor::interface = nullptr;
+SimulationInterface* Extractor::interface = nullptr;
 
 Extractor::Extractor(int uniqueId, int fund, ItemType resourceExtracted)
     : Seller(fund, uniqueId), resourceExtracted(resourceExtracted), nbExtracted(0)
 {
-    assert(resourceExtracted == ItemType::Copper ||
-           resourceExtracted == ItemType::Sand ||
-           resourceExtracted == ItemType::Petrol);
+    assert(recipeBook().recipeBegin(resourceExtracted) == recipeBook().recipeEnd(resourceExtracted));
     interface->consoleAppendText(uniqueId, QString("Mine Created"));
     interface->updateFund(uniqueId, fund);
 }
 
-std::map<ItemType, int> Extractor::getItemsForSale() {
-    return stocks;
+ItemsForSale Extractor::getItemsForSale() {
+    return stocks.snapshot();
 }
 
 
 int Extractor::trade(ItemType it, int qty) {
-    if (qty <= 0 || it != getResourceMined()) {
+    if (qty <= 0) {
+        stats.countTrade(TradeOutcome::InvalidQuantity);
+        return 0;
+    }
+    if (it != getResourceMined()) {
+        stats.countTrade(TradeOutcome::WrongItem);
         return 0;
     }
 
-    resourcesProtector.lock(); // Début S.C.
-    if (stocks[it] < qty) {
-        resourcesProtector.unlock(); // Fin S.C.
+    if (!stocks.tryRemove(it, qty)) {
+        stats.countTrade(TradeOutcome::OutOfStock);
         return 0;
     }
-    stocks[it] -= qty;
-    money += getMaterialCost() * qty;
-    resourcesProtector.unlock(); // Fin S.C.
+    stats.countTrade(TradeOutcome::Success);
+    /* Un seul relevé du prix, qui peut changer entre deux lectures */
+    int bill = getMaterialCost() * qty;
+    credit(bill);
 
     interface->updateFund(uniqueId, money);
-    interface->updateStock(uniqueId, &stocks);
+    interface->updateStock(uniqueId, publishStocks());
 
-    return getMaterialCost() * qty;
+    return bill;
 }
 
-void Extractor::run() {
+int Extractor::tradeBatch(Order& order, BatchMode mode) {
+    int bill = reserveBatch(order, mode, getResourceMined());
+
+    if (bill == 0) {
+        return 0;
+    }
+
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+
+    return bill;
+}
+
+bool Extractor::start() {
     interface->consoleAppendText(uniqueId, "[START] Mine routine");
+    ThreadRandom::bindStream(uniqueId);
+    return true;
+}
 
-    while (!PcoThread::thisThread()->stopRequested()) {
-        int minerCost = getEmployeeSalary(getEmployeeThatProduces(resourceExtracted));
-
-        resourcesProtector.lock(); // Début S.C.
-        if (money < minerCost) {
-            resourcesProtector.unlock(); // Fin S.C.
-            /* Pas assez d'argent */
-            /* Attend des jours meilleurs */
-            PcoThread::usleep(1000U);
-            continue;
-        }
-
-        /* On peut payer un mineur */
-        money -= minerCost;
-        resourcesProtector.unlock(); // Fin S.C.
-
-        /* Temps aléatoire borné qui simule le mineur qui mine */
-        PcoThread::usleep((rand() % 100 + 1) * 10000);
-        /* Statistiques */
-        nbExtracted++;
-        /* Incrément des stocks */
-        resourcesProtector.lock(); // Début S.C.
-        ++stocks[resourceExtracted];
-        resourcesProtector.unlock(); // Fin S.C.
-        /* Message dans l'interface graphique */
-        interface->consoleAppendText(uniqueId, QString("1 ") % getItemName(resourceExtracted) %
-                                     " has been mined");
-        /* Update de l'interface graphique */
-        interface->updateFund(uniqueId, money);
-        interface->updateStock(uniqueId, &stocks);
+Step Extractor::step() {
+    if (mining) {
+        completeMining();
+        return Step::next();
+    }
+
+    int minerCost = getEmployeeSalary(getEmployeeThatProduces(resourceExtracted));
+    /* Salaire débité puis compté comme versé */
+    LedgerTransfer transfer;
+
+    /* On paie un mineur si on en a les moyens */
+    if (!tryPay(minerCost)) {
+        /* Pas assez d'argent */
+        /* Attend qu'une vente nous renfloue */
+        return Step::wait();
+    }
+
+    /* Statistiques */
+    nbExtracted++;
+    mining = true;
+    /* Temps aléatoire borné qui simule le mineur qui mine */
+    return Step::sleep(drawBuildTimeUs(resourceExtracted));
+}
+
+void Extractor::finish() {
+    /* Le mineur déjà payé termine son travail */
+    if (mining) {
+        completeMining();
     }
     interface->consoleAppendText(uniqueId, "[STOP] Mine routine");
 }
 
+void Extractor::completeMining() {
+    mining = false;
+    EventLog::record(EventKind::Extract, uniqueId, -1, resourceExtracted, 1,
+                     getEmployeeSalary(getEmployeeThatProduces(resourceExtracted)));
+    /* Incrément des stocks */
+    restock(resourceExtracted, 1);
+    PricingEngine::recordSupply(resourceExtracted, 1);
+    if (market) {
+        market->postAsk(this, resourceExtracted, 1);
+    }
+    /* Message dans l'interface graphique */
+    interface->logTransaction({unsigned(uniqueId), LogKind::Mined, resourceExtracted, 1, 0});
+    /* Update de l'interface graphique */
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+}
+
 int Extractor::getMaterialCost() {
     return getCostPerUnit(resourceExtracted);
 }
@@ -102,7 +154,7 @@ int Extractor::getAmountPaidToMiners() {
     return nbExtracted * getEmployeeSalary(getEmployeeThatProduces(resourceExtracted));
 }
 
-void Extractor::setInterface(WindowInterface *windowInterface) {
+void Extractor::setInterface(SimulationInterface *windowInterface) {
     interface = windowInterface;
 }
 
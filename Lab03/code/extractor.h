@@ -1,8 +1,7 @@
 #ifndef EXTRACTOR_H
 #define EXTRACTOR_H
 #include <QTimer>
-#include "windowinterface.h"
-#include "costs.h"
+#include "simulationinterface.h"
 #include "seller.h"
 
 /**
@@ -10,7 +9,7 @@
  */
 class Extractor : public Seller {
 public:
-    static void setInterface(WindowInterface* interface);
+    static void setInterface(SimulationInterface* interface);
 
     /**
      * @brief Constructeur d'une mine
@@ -19,14 +18,14 @@ public:
      */
     Extractor(int uniqueId, int fund, ItemType resourceExtracted);
 
-    std::map<ItemType, int> getItemsForSale() override;
+    ItemsForSale getItemsForSale() override;
 
     /**
      * @brief Effectue une transaction de vente de ressources.
      *
      * Cette fonction gère la vente d'une quantité spécifiée de la ressource extraite. Elle vérifie d'abord si la
-     * transaction est possible (quantité positive et ressource correspondante), puis procède à la transaction
-     * en modifiant les stocks et en augmentant les fonds de l'extracteur de manière thread-safe.
+     * transaction est possible (quantité positive et ressource correspondante), puis réserve la quantité par
+     * compare-and-swap sur le compteur de stock et crédite atomiquement les fonds de l'extracteur.
      *
      * @param it Le type de ressource à vendre.
      * @param qty La quantité de ressource à vendre.
@@ -35,18 +34,25 @@ public:
     int trade(ItemType it, int qty) override;
 
     /**
-     * @brief Routine principale d'extraction exécutée par le thread de l'extracteur.
-     *
-     * Cette fonction simule le processus d'extraction en continu jusqu'à ce qu'un signal d'arrêt soit détecté.
-     * Elle gère le paiement des coûts de main-d'œuvre, l'extraction des ressources, la mise à jour des statistiques,
-     * et l'interaction avec l'interface utilisateur, tout en assurant que ces opérations sont sécurisées pour l'exécution
-     * concurrente.
+     * @brief Vend plusieurs lignes d'une commande en une transaction ; seule la ressource extraite est servie.
+     * @param order La commande, dont les quantités livrées sont mises à jour
+     * @param mode Tout ou rien, ou au mieux du stock disponible
+     * @return La facture totale, 0 si rien n'a été livré
+     */
+    int tradeBatch(Order& order, BatchMode mode) override;
+
+    bool start() override;
+
+    /**
+     * @brief Une étape de la routine d'extraction.
      *
-     * La boucle principale vérifie si l'extracteur a suffisamment de fonds pour payer le mineur. Si ce n'est pas le cas,
-     * l'extracteur attend et réessaie. Si les fonds sont suffisants, l'extracteur paie le mineur, mine la ressource,
-     * et met à jour les stocks et les fonds de manière sécurisée
+     * Tente de débiter le salaire du mineur. Si les fonds sont insuffisants, l'extracteur
+     * demande à attendre qu'une vente le renfloue. Sinon, il demande une pause le temps du
+     * minage ; l'étape suivante incrémente le stock de la ressource minée.
      */
-    void run();
+    Step step() override;
+
+    void finish() override;
 
     /**
      * @brief Fonction permettant de savoir quelle ressources la mine possède
@@ -65,10 +71,17 @@ public:
 private:
     // Identifiant du type de ressourcee miné
     const ItemType resourceExtracted;
-    // Compte le nombre d'employé payé
-    int nbExtracted;
+    // Compte le nombre d'employé payé, lu par l'auditeur des fonds
+    std::atomic<int> nbExtracted;
+    // Un mineur a été payé et la ressource n'est pas encore en stock
+    bool mining = false;
+
+    /**
+     * @brief Met en stock la ressource minée par le mineur payé
+     */
+    void completeMining();
 
-    static WindowInterface* interface;
+    static SimulationInterface* interface;
 };
 
 
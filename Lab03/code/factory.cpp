@@ -11,34 +11,68 @@
  * - Intégration d'une condition d'arrêt propre dans la méthode `run` pour permettre une terminaison gracieuse du thread.
  * - Implémentation de la logique de commande de ressources dans `orderResources` pour gérer les stocks insuffisants.
  * - Mise à jour de la méthode `trade` pour effectuer des transactions thread-safe de l'objet construit.
+ * - Remplacement du mutex par des compteurs atomiques pour les stocks et les fonds.
+ * - `orderResources` passe une seule commande groupée (`tradeBatch`) par grossiste.
+ * - Une commande non servie bloque l'usine jusqu'à un réassort de ses grossistes ou
+ *   une rentrée d'argent, au lieu d'une pause fixe d'une seconde.
+ * - Mode place de marché : les ressources manquantes font l'objet d'offres d'achat,
+ *   les objets construits d'offres de vente.
+ * - Temps d'assemblage tiré du générateur par thread (ThreadRandom) au lieu de `rand()`.
+ * - Les pauses passent par l'horloge de simulation injectée (Seller::setClock).
+ * - La routine est découpée en étapes non bloquantes (`step`) : l'assemblage et les attentes
+ *   sont rendus à l'appelant, thread de l'usine ou ordonnanceur à évènements discrets.
+ * - Statistiques : issue des ventes et latence de bout en bout des commandes de ressources.
+ * - Salaires, achats et offres d'achat encadrés comme transferts pour l'audit des fonds.
+ * - Recette, quantités et temps d'assemblage lus dans le catalogue chargé au démarrage (RecipeBook),
+ *   qui remplace les sous-classes PlasticFactory, ChipFactory et RobotFactory.
+ * - Production par lots : ressources, salaires et mise en stock réservés une fois par lot
+ *   de taille donnée par le catalogue, commandes dimensionnées pour un lot complet.
+ * - Politique de réassort (s, S) optionnelle, fondée sur le rythme de consommation observé :
+ *   les ressources sont commandées pendant l'assemblage. Taux d'utilisation des usines.
+ * - Ressources consommées, lots assemblés et achats inscrits au journal d'évènements.
+ * - Messages des échanges passés à l'interface sous forme binaire (`logTransaction`), sans mise en texte.
+ * - Grossistes vus comme vendeurs : ils peuvent être représentés dans un autre processus.
+ * - Lots assemblés et commandes comptés comme offre et demande par la tarification dynamique ;
+ *   achats inscrits au prix facturé par le grossiste. Une commande restée sans livraison et
+ *   redemandée n'est comptée qu'une fois.
  */
 
 #include "factory.h"
 #include "extractor.h"
-#include "costs.h"
 #include "wholesale.h"
-#include <pcosynchro/pcothread.h>
+#include "eventlog.h"
+#include "pricingengine.h"
+#include "marketplace.h"
+#include "moneyledger.h"
+#include "threadrandom.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <iostream>
 
-WindowInterface* Factory::interface = nullptr;
+SimulationInterface* Factory::interface = nullptr;
+ReorderPolicy Factory::reorderPolicy;
 
 
-Factory::Factory(int uniqueId, int fund, ItemType builtItem, std::vector<ItemType> resourcesNeeded)
-    : Seller(fund, uniqueId), resourcesNeeded(resourcesNeeded), itemBuilt(builtItem), nbBuild(0)
+Factory::Factory(int uniqueId, int fund, ItemType builtItem)
+    : Seller(fund, uniqueId),
+      resourcesNeeded(recipeBook().recipeBegin(builtItem), recipeBook().recipeEnd(builtItem)),
+      itemBuilt(builtItem), batchSize(recipeBook().batchSizes[RecipeBook::index(builtItem)]), nbBuild(0)
 {
-    assert(builtItem == ItemType::Chip ||
-           builtItem == ItemType::Plastic ||
-           builtItem == ItemType::Robot);
+    assert(!resourcesNeeded.empty());
 
     interface->updateFund(uniqueId, fund);
     interface->consoleAppendText(uniqueId, "Factory created");
 }
 
-void Factory::setWholesalers(std::vector<Wholesale *> wholesalers) {
+void Factory::setWholesalers(std::vector<Seller *> wholesalers) {
     Factory::wholesalers = wholesalers;
 
     for(Seller* seller: wholesalers){
         interface->setLink(uniqueId, seller->getUniqueId());
+        for (const Ingredient& resource : resourcesNeeded) {
+            seller->subscribeRestock(resource.item, &wakeup);
+        }
     }
 }
 
@@ -51,8 +85,8 @@ int Factory::getMaterialCost() {
 }
 
 bool Factory::verifyResources() {
-    for (auto item : resourcesNeeded) {
-        if (stocks[item] == 0) {
+    for (const Ingredient& resource : resourcesNeeded) {
+        if (stocks.get(resource.item) < resource.qty) {
             return false;
         }
     }
@@ -61,125 +95,337 @@ bool Factory::verifyResources() {
 }
 
 
-void Factory::buildItem() {
+Step Factory::buildItem() {
     int employeeCost = getEmployeeSalary(getEmployeeThatProduces(itemBuilt));
 
-    resourcesProtector.lock(); // Début S.C.
-    if (money < employeeCost) {
-        resourcesProtector.unlock(); // Fin S.C.
-        /* Pas assez d'argent */
-        return;
+    /* Taille du lot, bornée par les ressources en stock (au moins un objet) puis par les fonds */
+    int units = batchSize;
+    for (const Ingredient& resource : resourcesNeeded) {
+        units = std::min(units, stocks.get(resource.item) / resource.qty);
+    }
+    if (employeeCost > 0) {
+        units = std::min(units, getFund() / employeeCost);
     }
-    /* On peut payer un employé */
-    money -= employeeCost;
-    ++nbBuild;
 
-    for (auto resourceUsed : resourcesNeeded) {
-        --stocks[resourceUsed];
+    /* Salaires débités puis comptés comme versés, ou rendus si une ressource manque */
+    LedgerTransfer transfer;
+
+    if (units == 0 || !tryPay(employeeCost * units)) {
+        /* Pas assez d'argent, attente d'une vente */
+        return Step::wait();
     }
-    resourcesProtector.unlock(); // Fin S.C.
+
+    /* Réservation des ressources du lot, annulée si l'une d'elles manque */
+    for (auto it = resourcesNeeded.begin(); it != resourcesNeeded.end(); ++it) {
+        if (!stocks.tryRemove(it->item, it->qty * units)) {
+            for (auto used = resourcesNeeded.begin(); used != it; ++used) {
+                stocks.add(used->item, used->qty * units);
+            }
+            money += employeeCost * units;
+            return Step::next();
+        }
+    }
+    for (const Ingredient& resource : resourcesNeeded) {
+        EventLog::record(EventKind::Consume, uniqueId, -1, resource.item, resource.qty * units, 0);
+    }
+    /* Les employés sont payés */
+    nbBuild += units;
+    unitsInProgress = units;
+    recordConsumption(units);
 
     //Temps simulant l'assemblage d'un objet.
-    PcoThread::usleep((rand() % 100) * 100000);
+    std::uint64_t buildTimeUs = drawBuildTimeUs(itemBuilt);
+    busyUs += buildTimeUs;
+    return Step::sleep(buildTimeUs);
+}
 
-    resourcesProtector.lock(); // Début S.C.
-    ++stocks[getItemBuilt()];
-    resourcesProtector.unlock(); // Fin S.C.
+void Factory::completeBuild() {
+    int units = unitsInProgress;
+    unitsInProgress = 0;
+    EventLog::record(EventKind::Build, uniqueId, -1, itemBuilt, units,
+                     units * getEmployeeSalary(getEmployeeThatProduces(itemBuilt)));
+    restock(getItemBuilt(), units);
+    PricingEngine::recordSupply(itemBuilt, units);
+    if (market) {
+        market->postAsk(this, getItemBuilt(), units);
+    }
 
-    interface->consoleAppendText(uniqueId, "Factory have build a new object");
+    interface->logTransaction({unsigned(uniqueId), LogKind::Built, itemBuilt, units, 0});
 }
 
-void Factory::orderResources() {
-    int qty = 1;
+int Factory::unitsToOrder() {
+    int unitCost = 0;
+    for (const Ingredient& resource : resourcesNeeded) {
+        unitCost += resource.qty * getCostPerUnit(resource.item);
+    }
+    if (unitCost == 0) {
+        return batchSize;
+    }
+    return std::max(1, std::min(batchSize, getFund() / unitCost));
+}
 
-    for (auto resource : resourcesNeeded) {
-        if (stocks[resource] == 0) {
-            for (auto wholesaler : wholesalers) {
+void Factory::recordDemand(const Order& order) {
+    for (std::size_t i = 0; i < order.nbLines; ++i) {
+        const OrderLine& line = order.lines[i];
+        int fresh = line.qty - unmetDemand[static_cast<std::size_t>(line.item)];
+        if (fresh > 0) {
+            PricingEngine::recordDemand(line.item, fresh);
+        }
+    }
+}
 
-                resourcesProtector.lock(); // Début S.C.
-                if (money < getCostPerUnit(resource) * qty) {
-                    resourcesProtector.unlock(); // Fin S.C.
-                    continue;
-                }
-                resourcesProtector.unlock(); // Fin S.C.
+void Factory::passOrder(Order& order) {
+    for (auto wholesaler : wholesalers) {
+        if (order.empty()) {
+            break;
+        }
 
-                int bill = wholesaler->trade(resource, qty);
+        if (getFund() < order.cost()) {
+            break;
+        }
 
-                if (bill == 0) {
-                    continue;
-                }
+        int bill;
+        {
+            /* Le grossiste est crédité avant que l'usine ne soit débitée */
+            LedgerTransfer transfer;
+            bill = wholesaler->tradeBatch(order, BatchMode::BestEffort);
+            money -= bill;
+        }
 
-                resourcesProtector.lock(); // Début S.C.
-                money -= bill;
-                ++stocks[resource];
-                resourcesProtector.unlock(); // Fin S.C.
+        if (bill == 0) {
+            continue;
+        }
 
-                interface->consoleAppendText(uniqueId, QString("I bought %1 ").arg(qty) % getItemName(resource) % QString(" wich costed me %1").arg(bill));
-                break;
+        for (std::size_t i = 0; i < order.nbLines; ++i) {
+            const OrderLine& line = order.lines[i];
+            if (line.delivered > 0) {
+                EventLog::record(EventKind::Sale, wholesaler->getUniqueId(), uniqueId, line.item, line.delivered,
+                                 line.unitPrice * line.delivered);
+                stocks.add(line.item, line.delivered);
+                interface->logTransaction({unsigned(uniqueId), LogKind::Bought, line.item, line.delivered,
+                                           line.unitPrice * line.delivered});
             }
         }
+        order.removeDelivered();
     }
 
-    //Temps de pause pour éviter trop de demande
-    PcoThread::usleep(10 * 100000);
+    /* La part non servie sera redemandée sans être recomptée */
+    unmetDemand.fill(0);
+    for (std::size_t i = 0; i < order.nbLines; ++i) {
+        unmetDemand[static_cast<std::size_t>(order.lines[i].item)] = order.lines[i].qty;
+    }
 }
 
-void Factory::run() {
+bool Factory::bid(ItemType item, int qty) {
+    int price = qty * getCostPerUnit(item);
+    /* Le prix quitte les fonds avant d'entrer en séquestre */
+    LedgerTransfer transfer;
+    if (!tryPay(price)) {
+        return false;
+    }
+
+    onOrder.add(item, qty);
+    market->postBid(this, item, qty, &wholesalers);
+    interface->logTransaction({unsigned(uniqueId), LogKind::BidPlaced, item, qty, price});
+    return true;
+}
+
+Step Factory::orderResources() {
+    if (market) {
+        return orderFromMarketplace();
+    }
+
+    Order order;
+    int units = unitsToOrder();
+
+    for (const Ingredient& resource : resourcesNeeded) {
+        int missing = resource.qty * units - stocks.get(resource.item);
+        if (missing > 0) {
+            order.add(resource.item, missing);
+        }
+    }
+
+    recordDemand(order);
+    passOrder(order);
+
+    if (!order.empty()) {
+        /* Attente d'un réassort chez un grossiste ou d'une rentrée d'argent */
+        return Step::wait();
+    }
+    return Step::next();
+}
+
+Step Factory::orderFromMarketplace() {
+    int units = unitsToOrder();
+
+    for (const Ingredient& resource : resourcesNeeded) {
+        int missing = resource.qty * units - stocks.get(resource.item) - onOrder.get(resource.item);
+        if (missing > 0) {
+            bid(resource.item, missing);
+        }
+    }
+
+    /* Attente d'une livraison ou d'une rentrée d'argent */
+    return Step::wait();
+}
+
+void Factory::prefetch() {
+    /* Niveaux exprimés en objets produits, convertis ensuite en quantités de chaque ressource */
+    double reorderPoint = buildRate * reorderPolicy.leadTimeUs + double(reorderPolicy.safetyBatches) * batchSize;
+    double orderUpTo = reorderPoint + std::max(double(batchSize), buildRate * reorderPolicy.coverUs);
+    /* Les salaires du prochain lot restent disponibles */
+    int budget = getFund() - batchSize * getEmployeeSalary(getEmployeeThatProduces(itemBuilt));
+
+    Order order;
+    bool ordered = false;
+
+    for (const Ingredient& resource : resourcesNeeded) {
+        int position = stocks.get(resource.item) + onOrder.get(resource.item);
+        if (position > int(std::ceil(reorderPoint * resource.qty))) {
+            continue;
+        }
+
+        int qty = int(std::ceil(orderUpTo * resource.qty)) - position;
+        int cost = getCostPerUnit(resource.item);
+        if (cost > 0) {
+            qty = std::min(qty, budget / cost);
+        }
+        if (qty <= 0) {
+            continue;
+        }
+        budget -= qty * cost;
+
+        if (market) {
+            ordered = bid(resource.item, qty) || ordered;
+        } else {
+            order.add(resource.item, qty);
+            ordered = true;
+        }
+    }
+
+    if (ordered) {
+        ++nbPrefetches;
+    }
+    recordDemand(order);
+    passOrder(order);
+}
+
+void Factory::recordConsumption(int units) {
+    std::uint64_t now = simClock->localNow();
+    if (lastBuildUs && now > lastBuildUs) {
+        double rate = double(units) / double(now - lastBuildUs);
+        buildRate = buildRate > 0.0 ? buildRate + REORDER_RATE_SMOOTHING * (rate - buildRate) : rate;
+    }
+    lastBuildUs = now;
+}
+
+double Factory::getUtilization() const {
+    if (lastSeenUs <= startUs) {
+        return 0.0;
+    }
+    return std::min(1.0, double(busyUs) / double(lastSeenUs - startUs));
+}
+
+bool Factory::start() {
     if (wholesalers.empty()) {
         std::cerr << "You have to give to factories wholesalers to sales their resources" << std::endl;
-        return;
+        return false;
     }
     interface->consoleAppendText(uniqueId, "[START] Factory routine");
+    ThreadRandom::bindStream(uniqueId);
+    startUs = simClock->localNow();
+    lastSeenUs = startUs;
+    return true;
+}
 
-    while (!PcoThread::thisThread()->stopRequested()) {
-        if (verifyResources()) {
-            buildItem();
-        } else {
-            orderResources();
+Step Factory::step() {
+    Step next = Step::next();
+
+    if (unitsInProgress > 0) {
+        completeBuild();
+    } else if (verifyResources()) {
+        /* Latence de bout en bout de la commande qui vient d'être complétée */
+        if (orderStartUs) {
+            orderLatency.record(statsNowUs() - orderStartUs);
+            orderStartUs = 0;
+        }
+        if (reorderPolicy.enabled) {
+            prefetch();
         }
-        interface->updateFund(uniqueId, money);
-        interface->updateStock(uniqueId, &stocks);
+        next = buildItem();
+    } else {
+        if (!orderStartUs) {
+            orderStartUs = statsNowUs();
+        }
+        next = orderResources();
+    }
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+    /* Fin de l'étape sur le temps propre de l'usine, assemblage en cours compris */
+    lastSeenUs = simClock->localNow() + (next.kind == Step::Kind::Sleep ? next.delayUs : 0);
+    return next;
+}
+
+void Factory::finish() {
+    /* L'employé déjà payé termine l'objet */
+    if (unitsInProgress > 0) {
+        completeBuild();
     }
     interface->consoleAppendText(uniqueId, "[STOP] Factory routine");
 }
 
-std::map<ItemType, int> Factory::getItemsForSale() {
-    return std::map<ItemType, int>({{itemBuilt, stocks[itemBuilt]}});
+ItemsForSale Factory::getItemsForSale() {
+    ItemsForSale items{};
+    items[static_cast<std::size_t>(itemBuilt)] = stocks.get(itemBuilt);
+    return items;
 }
 
 int Factory::trade(ItemType it, int qty) {
-    if (qty <= 0 || it != getItemBuilt() || stocks[it] < qty) {
+    if (qty <= 0) {
+        stats.countTrade(TradeOutcome::InvalidQuantity);
+        return 0;
+    }
+    if (it != getItemBuilt()) {
+        stats.countTrade(TradeOutcome::WrongItem);
         return 0;
     }
 
-    resourcesProtector.lock(); // Début S.C.
-    if (stocks[it] < qty) {
-        resourcesProtector.unlock(); // Fin S.C.
+    if (!stocks.tryRemove(it, qty)) {
+        stats.countTrade(TradeOutcome::OutOfStock);
         return 0;
     }
-    stocks[it] -= qty;
-    money += getMaterialCost() * qty;
-    resourcesProtector.unlock(); // Fin S.C.
+    stats.countTrade(TradeOutcome::Success);
+    /* Un seul relevé du prix, qui peut changer entre deux lectures */
+    int bill = getMaterialCost() * qty;
+    credit(bill);
 
     interface->updateFund(uniqueId, money);
-    interface->updateStock(uniqueId, &stocks);
+    interface->updateStock(uniqueId, publishStocks());
 
-    return getMaterialCost() * qty;
+    return bill;
+}
+
+int Factory::tradeBatch(Order& order, BatchMode mode) {
+    int bill = reserveBatch(order, mode, getItemBuilt());
+
+    if (bill == 0) {
+        return 0;
+    }
+
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+
+    return bill;
 }
 
 int Factory::getAmountPaidToWorkers() {
     return Factory::nbBuild * getEmployeeSalary(getEmployeeThatProduces(itemBuilt));
 }
 
-void Factory::setInterface(WindowInterface *windowInterface) {
+void Factory::setInterface(SimulationInterface *windowInterface) {
     interface = windowInterface;
 }
 
-PlasticFactory::PlasticFactory(int uniqueId, int fund) :
-    Factory::Factory(uniqueId, fund, ItemType::Plastic, {ItemType::Petrol}) {}
-
-ChipFactory::ChipFactory(int uniqueId, int fund) :
-    Factory::Factory(uniqueId, fund, ItemType::Chip, {ItemType::Sand, ItemType::Copper}) {}
-
-RobotFactory::RobotFactory(int uniqueId, int fund) :
-    Factory::Factory(uniqueId, fund, ItemType::Robot, {ItemType::Chip, ItemType::Plastic}) {}
+void Factory::setReorderPolicy(const ReorderPolicy& policy) {
+    reorderPolicy = policy;
+}
@@ -1,11 +1,34 @@
 #ifndef FACTORY_H
 #define FACTORY_H
 #include <vector>
-#include "windowinterface.h"
+#include "simulationinterface.h"
 #include "seller.h"
 
 class Wholesale;
 
+// Poids d'un nouvel intervalle entre deux lots dans la moyenne glissante du rythme de consommation
+#define REORDER_RATE_SMOOTHING 0.2
+
+/**
+ * @brief Politique de réassort (s, S) des ressources d'une usine.
+ *
+ * Le point de commande s couvre la consommation observée pendant le délai de
+ * réapprovisionnement, plus un stock de sécurité. Dès que le stock d'une ressource,
+ * commandes en cours comprises, descend à s, l'usine le complète jusqu'à S, qui couvre
+ * en plus `coverUs` de consommation (au moins un lot). Les ressources sont ainsi
+ * commandées pendant que l'usine assemble, au lieu de l'être une fois épuisées.
+ */
+struct ReorderPolicy {
+    // Réassort anticipé ; sinon les ressources ne sont commandées qu'une fois épuisées
+    bool enabled = false;
+    // Délai de réapprovisionnement couvert par le point de commande (µs simulées)
+    std::uint64_t leadTimeUs = 1000000;
+    // Consommation couverte au-delà du point de commande par le niveau de recomplètement (µs simulées)
+    std::uint64_t coverUs = 5000000;
+    // Stock de sécurité, en nombre de lots
+    int safetyBatches = 1;
+};
+
 /**
  * @brief La classe permet l'implémentation d'une usine et de ces fonctions
  *        de ventes et d'achats.
@@ -16,28 +39,29 @@ public:
     /**
      * @brief Constructeur de la classe Factory
      * @param Fonds initiale
-     * @param La ressources qui sera construite par l'usine
-     * @param Vecteurs de ressources nécessaires pour construire l'objet
+     * @param La ressources qui sera construite par l'usine, dont la recette est copiée du catalogue
      */
-    Factory(int uniqueId, int fund, ItemType builtItem, std::vector<ItemType> resourcesNeeded);
+    Factory(int uniqueId, int fund, ItemType builtItem);
+
+    bool start() override;
 
     /**
-     * @brief Routine principale de l'usine exécutée par le thread de l'usine.
+     * @brief Une étape de la routine de l'usine.
      *
-     * Cette fonction exécute une boucle qui vérifie continuellement les ressources et déclenche la construction d'objets
-     * ou passe des commandes de ressources en fonction des besoins. La boucle se termine proprement lorsque l'arrêt du thread
-     * est demandé.
+     * Termine l'objet en cours d'assemblage, sinon vérifie les ressources et lance la construction d'un objet
+     * ou passe des commandes de ressources en fonction des besoins.
      */
-    void run();
+    Step step() override;
 
-    std::map<ItemType, int> getItemsForSale() override;
+    void finish() override;
+
+    ItemsForSale getItemsForSale() override;
 
     /**
      * @brief Effectue une transaction de vente de l'objet construit par l'usine.
      *
-     * Cette fonction gère la vente de l'objet construit. Elle vérifie si la quantité demandée est disponible et si oui,
-     * elle décrémente les stocks de l'objet et incrémente les fonds de l'usine, en s'assurant que ces opérations sont
-     * thread-safe grâce à l'utilisation de mutex pour encadrer les sections critiques.
+     * Cette fonction gère la vente de l'objet construit. La quantité demandée est réservée par compare-and-swap
+     * sur le compteur de stock de l'objet, puis les fonds de l'usine sont crédités atomiquement.
      *
      * @param it Le type d'objet à vendre.
      * @param qty La quantité d'objets à vendre.
@@ -45,6 +69,14 @@ public:
      */
     int trade(ItemType it, int number) override;
 
+    /**
+     * @brief Vend plusieurs lignes d'une commande en une transaction ; seul l'objet construit est servi.
+     * @param order La commande, dont les quantités livrées sont mises à jour
+     * @param mode Tout ou rien, ou au mieux du stock disponible
+     * @return La facture totale, 0 si rien n'a été livré
+     */
+    int tradeBatch(Order& order, BatchMode mode) override;
+
     /**
      * @brief Permet d'accèder au coût du matériel produit par l'usine
      * @return Le côût du metérial produit
@@ -59,25 +91,68 @@ public:
 
     /**
      * @brief Cette fonction permet d'affecter à une usine pluseurs grossistes pour pouvoir échanger avec eux.
-     * @param Vecteur de wholesaler
+     *        L'usine s'abonne au réassort, chez chacun d'eux, des ressources dont elle a besoin.
+     * @param Vecteur de wholesaler, éventuellement représentés dans un autre processus (RemoteSeller)
      */
-    void setWholesalers(std::vector<Wholesale*> wholesalers);
+    void setWholesalers(std::vector<Seller*> wholesalers);
 
     int getAmountPaidToWorkers();
 
-    static void setInterface(WindowInterface* windowInterface);
+    /**
+     * @brief Durées entre le constat d'une ressource manquante et le moment où toutes sont en stock
+     */
+    const LatencyHistogram& getOrderLatency() const { return orderLatency; }
+
+    /**
+     * @brief Part du temps simulé passée à assembler depuis le démarrage de la routine,
+     *        mesurée sur le temps propre de l'usine jusqu'à sa dernière étape
+     * @return Un taux entre 0 et 1
+     */
+    double getUtilization() const;
+
+    /**
+     * @brief Nombre de commandes anticipées par la politique de réassort
+     */
+    std::uint64_t getNbPrefetches() const { return nbPrefetches; }
+
+    static void setInterface(SimulationInterface* windowInterface);
+
+    /**
+     * @brief Choisit la politique de réassort de toutes les usines, avant leur démarrage
+     */
+    static void setReorderPolicy(const ReorderPolicy& policy);
 
 private:
-    // Liste de grossiste auxquels l'usine peut acheter des ressources
-    std::vector<Wholesale*> wholesalers;
-    // Liste de ressources voulus pour la production d'un objet
-    const std::vector<ItemType> resourcesNeeded;
+    // Liste de grossiste auxquels l'usine peut acheter des ressources, aussi ceux des offres d'achat
+    std::vector<Seller*> wholesalers;
+    // Liste de ressources voulus pour la production d'un objet, avec leur quantité
+    const std::vector<Ingredient> resourcesNeeded;
     // Identifiant de l'objet produit par l'usine, selon l'enum ItemType
     const ItemType itemBuilt;
-    // Compte le nombre d'employé payé
-    int nbBuild;
-
-    static WindowInterface* interface;
+    // Nombre maximal d'objets assemblés par cycle, selon le catalogue
+    const int batchSize;
+    // Compte le nombre d'employé payé, lu par l'auditeur des fonds
+    std::atomic<int> nbBuild;
+    // Nombre d'objets en cours d'assemblage, dont les ressources sont consommées
+    int unitsInProgress = 0;
+    // Début de la commande en cours (µs de temps réel), 0 si aucune ressource ne manque
+    std::uint64_t orderStartUs = 0;
+    LatencyHistogram orderLatency;
+
+    // Objets produits par µs simulée, moyenne glissante
+    double buildRate = 0.0;
+    // Début du dernier lot (µs simulées), 0 avant le premier
+    std::uint64_t lastBuildUs = 0;
+    // Démarrage de la routine, fin de la dernière étape et temps passé à assembler (µs simulées)
+    std::uint64_t startUs = 0;
+    std::uint64_t lastSeenUs = 0;
+    std::uint64_t busyUs = 0;
+    std::uint64_t nbPrefetches = 0;
+    // Quantités restées sans livraison après la dernière commande, déjà comptées comme demande
+    ItemsForSale unmetDemand{};
+
+    static SimulationInterface* interface;
+    static ReorderPolicy reorderPolicy;
 
     /**
      * @brief Fonction privée permettant de vérifier si l'usine à toute les ressources
@@ -87,46 +162,81 @@ private:
     bool verifyResources();
 
     /**
-     * @brief Commande des ressources aux grossistes si les stocks sont insuffisants.
-     *
-     * Cette fonction itère sur les ressources nécessaires et, si les stocks sont à zéro, elle passe une commande auprès
-     * des grossistes disponibles, en vérifiant que l'usine a suffisamment d'argent avant de passer la commande.
-     * Après l'achat, elle met à jour les stocks et les fonds de l'usine. Les modifications des ressources et des fonds
-     * sont protégées par des mutex pour éviter toute condition de concurrence.
+     * @brief Nombre d'objets pour lesquels commander des ressources : un lot complet,
+     *        réduit à ce que les fonds permettent d'acheter, au moins un.
      */
-    void orderResources();
+    int unitsToOrder();
 
     /**
-     * @brief Construit l'objet spécifié par l'usine.
+     * @brief Passe une commande aux grossistes l'un après l'autre, au mieux de leur stock,
+     *        tant qu'elle n'est pas entièrement servie et que les fonds la couvrent.
+     * @param order La commande, dont il ne reste que la part non servie
+     */
+    void passOrder(Order& order);
+
+    /**
+     * @brief Compte comme demande (PricingEngine) ce qu'une nouvelle commande demande de plus
+     *        que la part encore non servie de la précédente, déjà comptée
+     */
+    void recordDemand(const Order& order);
+
+    /**
+     * @brief Prélève le prix de ressources sur les fonds et dépose l'offre d'achat correspondante
+     * @return false si les fonds sont insuffisants
+     */
+    bool bid(ItemType item, int qty);
+
+    /**
+     * @brief Complète jusqu'au niveau S les ressources dont le stock est descendu au point de commande s.
      *
-     * Cette fonction déclenche le processus de construction de l'objet après avoir vérifié et déduit les coûts des employés.
-     * Elle décrémente ensuite les stocks des ressources nécessaires et incrémente les stocks de l'objet construit.
-     * L'accès aux variables partagées telles que les stocks et les fonds est protégé par des mutex pour assurer
-     * la synchronisation entre les threads.
+     * Les fonds nécessaires aux salaires du prochain lot sont préservés, la commande est réduite
+     * en conséquence. Elle n'attend jamais : ce qui n'est pas servi sera recommandé plus tard.
      */
-    void buildItem();
-};
+    void prefetch();
 
+    /**
+     * @brief Met à jour le rythme de consommation observé avec un nouveau lot
+     * @param units Le nombre d'objets du lot
+     */
+    void recordConsumption(int units);
 
-// Si dessous sont les trois types d'usines. Elle vont créer des usines en leur
-// spécifiant les besoins en matérial et leur identifiant.
+    /**
+     * @brief Commande des ressources aux grossistes si les stocks sont insuffisants.
+     *
+     * Cette fonction regroupe les quantités qui manquent pour un lot complet dans une seule commande et la passe
+     * aux grossistes l'un après l'autre (au mieux de leur stock), jusqu'à ce qu'elle soit entièrement servie.
+     * L'usine vérifie qu'elle a suffisamment d'argent avant chaque commande. Si la commande n'est pas entièrement
+     * servie, l'usine demande à attendre qu'un grossiste réassortisse une ressource voulue ou qu'une vente la
+     * renfloue. Après l'achat, elle met à jour les stocks et les fonds de l'usine au moyen d'opérations atomiques.
+     * @return La suite de la routine
+     */
+    Step orderResources();
 
-class PlasticFactory : public Factory{
-private:
-public:
-    PlasticFactory(int uniqueId, int fund);
-};
+    /**
+     * @brief Variante de orderResources en mode place de marché.
+     *
+     * Pour chaque quantité manquante qui n'est pas déjà commandée, l'usine prélève le prix sur ses fonds
+     * et dépose une offre d'achat auprès de ses grossistes, puis demande à attendre une livraison ou une
+     * rentrée d'argent.
+     * @return La suite de la routine
+     */
+    Step orderFromMarketplace();
 
-class ChipFactory : public Factory {
-private:
-public:
-    ChipFactory(int uniqueId, int fund);
-};
+    /**
+     * @brief Lance l'assemblage d'un lot d'objets.
+     *
+     * Le lot compte au plus `batchSize` objets, autant que le permettent les ressources en stock et les fonds.
+     * Cette fonction réserve d'un coup les ressources de tout le lot et débite d'un coup les salaires ; si l'une
+     * des réservations échoue, les autres sont annulées. L'assemblage du lot prend la durée d'une seule pause.
+     * Stocks et fonds sont des compteurs atomiques, aucun verrou n'est nécessaire.
+     * @return La suite de la routine
+     */
+    Step buildItem();
 
-class RobotFactory : public Factory {
-private:
-public:
-    RobotFactory(int uniqueId, int fund);
+    /**
+     * @brief Met en stock, en une seule mise à jour, les objets du lot assemblé
+     */
+    void completeBuild();
 };
 
 #endif // FACTORY_H
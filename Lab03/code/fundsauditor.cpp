@@ -0,0 +1,56 @@
+/**
+ * @file fundsauditor.cpp
+ * @brief Audit de la conservation de l'argent pendant la simulation, sans bloquer les vendeurs.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "fundsauditor.h"
+#include "moneyledger.h"
+#include <algorithm>
+#include <iostream>
+#include <pcosynchro/pcothread.h>
+
+// Granularité de l'attente entre deux audits, pour réagir vite à stop()
+#define AUDIT_POLL_US 10000
+
+FundsAuditor::FundsAuditor(std::function<long long()> measure, long long expected, std::uint64_t periodUs)
+    : measure(std::move(measure)), expected(expected), periodUs(periodUs) {}
+
+bool FundsAuditor::audit() {
+    for (int attempt = 0; attempt < AUDIT_MAX_ATTEMPTS; ++attempt) {
+        MoneyLedger::Stamp before = MoneyLedger::stamp();
+        if (!before.quiescent) {
+            ++nbRetries;
+            continue;
+        }
+
+        long long total = measure();
+
+        if (!MoneyLedger::unchangedSince(before)) {
+            ++nbRetries;
+            continue;
+        }
+
+        ++nbAudits;
+        if (total != expected) {
+            ++nbViolations;
+            std::cerr << "Funds audit : expected " << expected << " but counted " << total << std::endl;
+        }
+        return true;
+    }
+
+    ++nbSkipped;
+    return false;
+}
+
+void FundsAuditor::run() {
+    while (!stopping.load()) {
+        for (std::uint64_t waited = 0; waited < periodUs && !stopping.load(); waited += AUDIT_POLL_US) {
+            PcoThread::usleep(std::min<std::uint64_t>(AUDIT_POLL_US, periodUs - waited));
+        }
+        if (!stopping.load()) {
+            audit();
+        }
+    }
+}
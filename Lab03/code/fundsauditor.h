@@ -0,0 +1,69 @@
+#ifndef FUNDSAUDITOR_H
+#define FUNDSAUDITOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Nombre de lectures tentées par audit avant d'y renoncer
+#define AUDIT_MAX_ATTEMPTS 64
+
+/**
+ * @brief Vérifie périodiquement, pendant la simulation, que l'argent est conservé.
+ *
+ * À chaque période, l'auditeur additionne les fonds de tous les vendeurs, les salaires
+ * versés et le séquestre de la place de marché, entre deux relevés du MoneyLedger. Si
+ * un transfert était en cours ou s'est produit pendant la lecture, la somme est
+ * écartée et la lecture recommencée ; les vendeurs ne sont jamais bloqués. Une somme
+ * cohérente différente du montant attendu est une violation, signalée immédiatement.
+ */
+class FundsAuditor
+{
+public:
+    /**
+     * @param measure Calcule le total fonds + salaires + séquestre
+     * @param expected Le total attendu (fonds initiaux)
+     * @param periodUs Temps réel entre deux audits, en microsecondes
+     */
+    FundsAuditor(std::function<long long()> measure, long long expected, std::uint64_t periodUs);
+
+    /**
+     * @brief Routine du thread de l'auditeur, jusqu'à l'appel de stop()
+     */
+    void run();
+
+    void stop() { stopping = true; }
+
+    /**
+     * @brief Effectue un audit
+     * @return true si une lecture cohérente a été obtenue
+     */
+    bool audit();
+
+    std::uint64_t getNbAudits() const { return nbAudits.load(); }
+
+    /**
+     * @brief Audits abandonnés faute d'avoir obtenu une lecture cohérente
+     */
+    std::uint64_t getNbSkipped() const { return nbSkipped.load(); }
+
+    std::uint64_t getNbViolations() const { return nbViolations.load(); }
+
+    /**
+     * @brief Lectures recommencées à cause d'un transfert concurrent
+     */
+    std::uint64_t getNbRetries() const { return nbRetries.load(); }
+
+private:
+    std::function<long long()> measure;
+    const long long expected;
+    const std::uint64_t periodUs;
+
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> nbAudits{0};
+    std::atomic<std::uint64_t> nbSkipped{0};
+    std::atomic<std::uint64_t> nbViolations{0};
+    std::atomic<std::uint64_t> nbRetries{0};
+};
+
+#endif // FUNDSAUDITOR_H
@@ -0,0 +1,99 @@
+/**
+ * @file headlessinterface.cpp
+ * @brief Implémentation de l'interface de simulation sans affichage graphique.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "headlessinterface.h"
+#include <iostream>
+
+HeadlessInterface::HeadlessInterface(bool verbose) : verbose(verbose) {
+    if (verbose) {
+        log = std::make_unique<TransactionLog>(HEADLESS_LOG_CAPACITY);
+        logThread = std::make_unique<PcoThread>(&HeadlessInterface::printLog, this);
+    }
+}
+
+HeadlessInterface::~HeadlessInterface() {
+    closeLog();
+}
+
+void HeadlessInterface::consoleAppendText(unsigned int consoleId, QString text) {
+    nbConsoleMessages.fetch_add(1, std::memory_order_relaxed);
+    if (verbose) {
+        std::cout << "[" << consoleId << "] " << text.toStdString() << std::endl;
+    }
+}
+
+void HeadlessInterface::logTransaction(const LogRecord& record) {
+    nbConsoleMessages.fetch_add(1, std::memory_order_relaxed);
+    if (log) {
+        log->tryPush(record);
+    }
+}
+
+void HeadlessInterface::closeLog() {
+    if (!logThread) {
+        return;
+    }
+    logThread->requestStop();
+    logThread->join();
+    logThread.reset();
+    drainLog();
+}
+
+void HeadlessInterface::printLog() {
+    while (!PcoThread::thisThread()->stopRequested()) {
+        drainLog();
+        PcoThread::usleep(HEADLESS_LOG_POLL_US);
+    }
+}
+
+void HeadlessInterface::drainLog() {
+    LogRecord record;
+    while (log->tryPop(record)) {
+        std::cout << "[" << record.consoleId << "] " << formatLogRecord(record).toStdString() << '\n';
+    }
+    std::cout.flush();
+}
+
+void HeadlessInterface::updateFund(unsigned int /*id*/, unsigned /*new_fund*/) {
+    nbFundUpdates.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HeadlessInterface::updateStock(unsigned int /*id*/, const SeqLock<ItemsForSale>* /*stocks*/) {
+    nbStockUpdates.fetch_add(1, std::memory_order_relaxed);
+}
+
+void HeadlessInterface::setLink(int /*from*/, int /*to*/) {
+    nbLinks.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned long long HeadlessInterface::getNbConsoleMessages() const {
+    return nbConsoleMessages.load(std::memory_order_relaxed);
+}
+
+unsigned long long HeadlessInterface::getNbFundUpdates() const {
+    return nbFundUpdates.load(std::memory_order_relaxed);
+}
+
+unsigned long long HeadlessInterface::getNbStockUpdates() const {
+    return nbStockUpdates.load(std::memory_order_relaxed);
+}
+
+unsigned long long HeadlessInterface::getNbLinks() const {
+    return nbLinks.load(std::memory_order_relaxed);
+}
+
+QString HeadlessInterface::getThroughputReport(double elapsedSeconds) const {
+    if (elapsedSeconds <= 0.0) {
+        elapsedSeconds = 1.0;
+    }
+
+    return QString("Console messages : %1 (%2/s)\n").arg(getNbConsoleMessages()).arg(getNbConsoleMessages() / elapsedSeconds) %
+           QString("Fund updates     : %1 (%2/s)\n").arg(getNbFundUpdates()).arg(getNbFundUpdates() / elapsedSeconds) %
+           QString("Stock updates    : %1 (%2/s)\n").arg(getNbStockUpdates()).arg(getNbStockUpdates() / elapsedSeconds) %
+           QString("Links            : %1").arg(getNbLinks()) %
+           (log ? QString("\nDropped messages : %1").arg(log->getNbDropped()) : QString());
+}
@@ -0,0 +1,83 @@
+#ifndef HEADLESSINTERFACE_H
+#define HEADLESSINTERFACE_H
+
+#include <atomic>
+#include <memory>
+#include <pcosynchro/pcothread.h>
+#include "simulationinterface.h"
+#include "transactionlog.h"
+
+// Nombre de messages d'échange en attente d'affichage au plus, en mode verbeux
+#define HEADLESS_LOG_CAPACITY 65536
+// Pause du thread d'affichage quand la file de messages est vide (µs)
+#define HEADLESS_LOG_POLL_US 1000
+
+/**
+ * @brief Implémentation de SimulationInterface sans affichage.
+ *
+ * Aucun signal Qt n'est émis : chaque appel incrémente simplement un compteur atomique,
+ * ce qui permet de faire tourner la simulation sur un serveur sans écran et d'en
+ * mesurer le débit.
+ *
+ * En mode verbeux, les messages d'échange sont déposés sous forme binaire dans une
+ * TransactionLog, mis en texte et écrits sur la sortie standard par un thread dédié.
+ */
+class HeadlessInterface : public SimulationInterface
+{
+public:
+    /**
+     * @brief Constructeur
+     * @param verbose Si vrai, les messages de console sont recopiés sur la sortie standard
+     */
+    explicit HeadlessInterface(bool verbose = false);
+
+    ~HeadlessInterface() override;
+
+    void consoleAppendText(unsigned int consoleId, QString text) override;
+    void logTransaction(const LogRecord& record) override;
+
+    /**
+     * @brief Écrit les messages d'échange encore en attente et arrête le thread d'affichage.
+     *        À appeler une fois les vendeurs arrêtés, avant d'écrire le bilan.
+     */
+    void closeLog();
+
+    void updateFund(unsigned int id, unsigned new_fund) override;
+    void updateStock(unsigned int id, const SeqLock<ItemsForSale>* stocks) override;
+    void setLink(int from, int to) override;
+
+    unsigned long long getNbConsoleMessages() const;
+    unsigned long long getNbFundUpdates() const;
+    unsigned long long getNbStockUpdates() const;
+    unsigned long long getNbLinks() const;
+
+    /**
+     * @brief Construit un rapport de débit
+     * @param elapsedSeconds Durée de la simulation en secondes
+     * @return Le nombre d'évènements reçus et leur débit par seconde
+     */
+    QString getThroughputReport(double elapsedSeconds) const;
+
+private:
+    /**
+     * @brief Routine du thread d'affichage : met en texte et écrit les messages d'échange
+     */
+    void printLog();
+
+    /**
+     * @brief Écrit tous les messages d'échange publiés
+     */
+    void drainLog();
+
+    const bool verbose;
+
+    std::unique_ptr<TransactionLog> log;
+    std::unique_ptr<PcoThread> logThread;
+
+    std::atomic<unsigned long long> nbConsoleMessages{0};
+    std::atomic<unsigned long long> nbFundUpdates{0};
+    std::atomic<unsigned long long> nbStockUpdates{0};
+    std::atomic<unsigned long long> nbLinks{0};
+};
+
+#endif // HEADLESSINTERFACE_H
@@ -0,0 +1,20 @@
+#ifndef ITEMTYPE_H
+#define ITEMTYPE_H
+
+#include <array>
+#include <cstddef>
+
+enum class ItemType { Sand, Copper, Petrol, Chip, Plastic, Robot, Nothing};
+
+// Nombre de types d'objets échangeables (ItemType::Nothing exclu)
+constexpr std::size_t NB_ITEM_TYPES = static_cast<std::size_t>(ItemType::Nothing);
+
+// Taille d'une ligne de cache, utilisée pour éviter le faux partage entre compteurs
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Quantités indexées par ItemType, copiées par valeur (aucune allocation).
+ */
+using ItemsForSale = std::array<int, NB_ITEM_TYPES>;
+
+#endif // ITEMTYPE_H
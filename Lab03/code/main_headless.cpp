@@ -0,0 +1,277 @@
+/**
+ * @file main_headless.cpp
+ * @brief Point d'entrée de la simulation sans affichage.
+ *
+ * Usage : Lab3_Factory_headless [--extractors N] [--factories N] [--wholesalers N]
+ *                               [--duration secondes] [--marketplace] [--seed N]
+ *                               [--clock real|scaled|fast] [--time-scale F]
+ *                               [--scheduler threads|events|pool|coroutines] [--workers N]
+ *                               [--sim-duration secondes] [--topology fichier] [--regions N]
+ *                               [--factory-fanout N] [--supplier-fanout N] [--cross-region F]
+ *                               [--stats fichier.csv|fichier.json] [--audit ms]
+ *                               [--recipes fichier] [--reorder] [--lead-time secondes]
+ *                               [--cover secondes] [--safety lots] [--record fichier]
+ *                               [--replay fichier] [--sharded-wholesalers] [--partitions N]
+ *                               [--dynamic-prices] [--price-bucket secondes]
+ *                               [--price-elasticity F] [--verbose]
+ *
+ * La simulation tourne pendant la durée demandée (ou jusqu'à la durée simulée, avec
+ * l'ordonnanceur à évènements discrets), puis les threads sont arrêtés
+ * proprement et le rapport final (conservation des fonds) ainsi que le débit
+ * d'évènements sont affichés sur la sortie standard.
+ *
+ * Avec --partitions N, les vendeurs sont répartis entre N processus qui s'échangent les
+ * appels par sockets Unix ; seul le processus principal affiche le rapport, complété du
+ * bilan de tous les processus.
+ *
+ * Avec --dynamic-prices, les prix suivent l'offre et la demande des dernières tranches
+ * de --price-bucket secondes simulées (un seul processus : pas de --partitions).
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "utils.h"
+#include "headlessinterface.h"
+#include "threadrandom.h"
+
+#define DEFAULT_DURATION_S 10
+
+static void usage(const char* program) {
+    std::cerr << "Usage : " << program
+              << " [--extractors N] [--factories N] [--wholesalers N]"
+              << " [--duration secondes] [--marketplace] [--seed N]"
+              << " [--clock real|scaled|fast] [--time-scale F]"
+              << " [--scheduler threads|events|pool|coroutines] [--workers N]"
+              << " [--sim-duration secondes] [--topology fichier] [--regions N]"
+              << " [--factory-fanout N] [--supplier-fanout N] [--cross-region F]"
+              << " [--stats fichier.csv|fichier.json] [--audit ms] [--recipes fichier]"
+              << " [--reorder] [--lead-time secondes] [--cover secondes] [--safety lots]"
+              << " [--record fichier] [--replay fichier] [--sharded-wholesalers] [--partitions N]"
+              << " [--dynamic-prices] [--price-bucket secondes] [--price-elasticity F]"
+              << " [--verbose]" << std::endl;
+}
+
+/**
+ * @brief Rejoue un journal enregistré avec --record et affiche le bilan
+ */
+static int replay(const char* path) {
+    ReplayResult result = replayEventLog(path);
+    if (!result.loaded) {
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Replayed " << result.nbEvents << " events in " << result.seconds << " s ("
+              << result.nbEvents / std::max(result.seconds, 1e-9) << " events/s), "
+              << result.lastTimeUs / 1e6 << " simulated s" << std::endl;
+    std::cout << "Recorded with seed " << result.header.seed << " : " << result.header.nbExtractors << " extractors, "
+              << result.header.nbFactories << " factories, " << result.header.nbWholesalers << " wholesalers" << std::endl;
+    std::cout << "The expected fund is : " << result.startFund << " and you got at the end : " << result.endFund << std::endl;
+    if (result.nbMismatches) {
+        std::cout << result.nbMismatches << " final funds or stocks differ from the recording" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "Final funds and stocks match the recording" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    int nbExtractors = NB_EXTRACTOR;
+    int nbFactories = NB_FACTORIES;
+    int nbWholesalers = NB_WHOLESALER;
+    int duration = DEFAULT_DURATION_S;
+    bool verbose = false;
+    const char* replayPath = nullptr;
+    unsigned nbPartitions = 1;
+    SimulationOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+
+        if (!std::strcmp(argv[i], "--extractors") && hasValue) {
+            nbExtractors = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--factories") && hasValue) {
+            nbFactories = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--wholesalers") && hasValue) {
+            nbWholesalers = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--duration") && hasValue) {
+            duration = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--marketplace")) {
+            options.useMarketplace = true;
+        } else if (!std::strcmp(argv[i], "--seed") && hasValue) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (!std::strcmp(argv[i], "--clock") && hasValue) {
+            const char* mode = argv[++i];
+            if (!std::strcmp(mode, "real")) {
+                options.clock = ClockMode::RealTime;
+            } else if (!std::strcmp(mode, "scaled")) {
+                options.clock = ClockMode::Scaled;
+            } else if (!std::strcmp(mode, "fast")) {
+                options.clock = ClockMode::Fast;
+            } else {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (!std::strcmp(argv[i], "--time-scale") && hasValue) {
+            options.timeScale = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--scheduler") && hasValue) {
+            const char* mode = argv[++i];
+            if (!std::strcmp(mode, "threads")) {
+                options.scheduler = SchedulerMode::Threads;
+            } else if (!std::strcmp(mode, "events")) {
+                options.scheduler = SchedulerMode::DiscreteEvent;
+            } else if (!std::strcmp(mode, "pool")) {
+                options.scheduler = SchedulerMode::WorkStealing;
+            } else if (!std::strcmp(mode, "coroutines")) {
+                options.scheduler = SchedulerMode::Coroutines;
+            } else {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (!std::strcmp(argv[i], "--workers") && hasValue) {
+            options.nbWorkers = unsigned(std::atoi(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--sim-duration") && hasValue) {
+            options.simulatedDurationUs = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1e6);
+        } else if (!std::strcmp(argv[i], "--topology") && hasValue) {
+            /* Les effectifs du fichier remplacent ceux donnés jusqu'ici */
+            options.topology.nbExtractors = nbExtractors;
+            options.topology.nbFactories = nbFactories;
+            options.topology.nbWholesalers = nbWholesalers;
+            if (!loadTopologyConfig(argv[++i], options.topology)) {
+                return EXIT_FAILURE;
+            }
+            nbExtractors = options.topology.nbExtractors;
+            nbFactories = options.topology.nbFactories;
+            nbWholesalers = options.topology.nbWholesalers;
+        } else if (!std::strcmp(argv[i], "--regions") && hasValue) {
+            options.topology.nbRegions = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--factory-fanout") && hasValue) {
+            options.topology.factoryFanOut = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--supplier-fanout") && hasValue) {
+            options.topology.supplierFanOut = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--cross-region") && hasValue) {
+            options.topology.crossRegion = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--stats") && hasValue) {
+            options.statsPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--audit") && hasValue) {
+            options.auditPeriodUs = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1000);
+        } else if (!std::strcmp(argv[i], "--recipes") && hasValue) {
+            /* Chargé avant la création des vendeurs, qui copient leur recette */
+            if (!loadRecipeBook(argv[++i])) {
+                return EXIT_FAILURE;
+            }
+        } else if (!std::strcmp(argv[i], "--reorder")) {
+            options.reorder.enabled = true;
+        } else if (!std::strcmp(argv[i], "--lead-time") && hasValue) {
+            options.reorder.leadTimeUs = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1e6);
+        } else if (!std::strcmp(argv[i], "--cover") && hasValue) {
+            options.reorder.coverUs = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1e6);
+        } else if (!std::strcmp(argv[i], "--safety") && hasValue) {
+            options.reorder.safetyBatches = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--record") && hasValue) {
+            options.eventLogPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--replay") && hasValue) {
+            replayPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "--sharded-wholesalers")) {
+            options.shardedWholesalers = true;
+        } else if (!std::strcmp(argv[i], "--partitions") && hasValue) {
+            nbPartitions = unsigned(std::max(1, std::atoi(argv[++i])));
+        } else if (!std::strcmp(argv[i], "--dynamic-prices")) {
+            options.pricing.enabled = true;
+        } else if (!std::strcmp(argv[i], "--price-bucket") && hasValue) {
+            options.pricing.bucketUs = static_cast<std::uint64_t>(std::atof(argv[++i]) * 1e6);
+        } else if (!std::strcmp(argv[i], "--price-elasticity") && hasValue) {
+            options.pricing.elasticity = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--verbose")) {
+            verbose = true;
+        } else {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (options.clock == ClockMode::Scaled && options.timeScale <= 0.0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (options.pricing.enabled && options.pricing.bucketUs == 0) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    /* Une offre séquestre son montant au dépôt, alors que le vendeur serait payé au prix du moment */
+    if (options.pricing.enabled && options.useMarketplace) {
+        std::cerr << "--dynamic-prices cannot be combined with --marketplace" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* Le rejeu relit un seul journal dans un seul processus */
+    if (nbPartitions > 1 && replayPath) {
+        std::cerr << "--partitions cannot be combined with --replay" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    /* Les processus sont créés avant tout thread, l'interface en verbeux comprise */
+    std::unique_ptr<Partition> partition;
+    if (nbPartitions > 1) {
+        /* Chaque processus aurait ses propres prix, l'offre comptée chez le vendeur et la demande chez l'acheteur */
+        if (options.useMarketplace || options.scheduler == SchedulerMode::DiscreteEvent ||
+            !options.eventLogPath.empty() || options.pricing.enabled) {
+            std::cerr << "--partitions cannot be combined with --marketplace, --scheduler events, --record"
+                      << " or --dynamic-prices" << std::endl;
+            return EXIT_FAILURE;
+        }
+        /* Tous les processus doivent construire le même réseau d'échanges */
+        ThreadRandom::seed(options.seed);
+        options.seed = ThreadRandom::getSeed();
+
+        partition = Partition::spawn(nbPartitions);
+        if (!partition) {
+            return EXIT_FAILURE;
+        }
+        options.partition = partition.get();
+        if (!partition->isMain()) {
+            options.statsPath.clear();
+        }
+    }
+
+    auto interface = new HeadlessInterface(verbose);
+
+    Extractor::setInterface(interface);
+    Factory::setInterface(interface);
+    Wholesale::setInterface(interface);
+
+    if (replayPath) {
+        int status = replay(replayPath);
+        delete interface;
+        return status;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Utils utils(nbExtractors, nbFactories, nbWholesalers, options);
+
+    /* Attente de la durée demandée, écourtée si la durée simulée est atteinte avant */
+    auto deadline = start + std::chrono::seconds(duration);
+    while (!utils.isFinished() && std::chrono::steady_clock::now() < deadline) {
+        PcoThread::usleep(10000);
+    }
+    utils.externalEndService();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    interface->closeLog();
+
+    std::cout << utils.getFinalReport().toStdString() << std::endl;
+    std::cout << "Sellers : " << nbExtractors << " extractors, " << nbFactories << " factories, "
+              << nbWholesalers << " wholesalers, " << elapsed.count() << " s" << std::endl;
+    std::cout << interface->getThroughputReport(elapsed.count()).toStdString() << std::endl;
+
+    delete interface;
+
+    return EXIT_SUCCESS;
+}
@@ -58,7 +58,7 @@ void MainWindow::consoleAppendText(unsigned int consoleId, const QString &text){
     m_consoles[consoleId]->append(text);
 }
 
-void MainWindow::updateStock(unsigned int id, std::map<ItemType, int>* stocks){
+void MainWindow::updateStock(unsigned int id, const ItemsForSale& stocks){
     display->update_stocks(id, stocks);
 }
 
@@ -34,7 +34,7 @@ public slots:
 //    void handleButton();
 
     void updateFund(unsigned int id, unsigned new_fund);
-    void updateStock(unsigned int id, std::map<ItemType, int>* stocks);
+    void updateStock(unsigned int id, const ItemsForSale& stocks);
     void set_link(int from, int to);
 private:
 //    QPushButton *m_button;
@@ -0,0 +1,172 @@
+/**
+ * @file marketplace.cpp
+ * @brief Carnet d'ordres central et thread d'appariement des offres.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "marketplace.h"
+#include "eventlog.h"
+#include "seller.h"
+#include "moneyledger.h"
+#include <algorithm>
+
+void Marketplace::lock() {
+    std::uint64_t requested = statsNowUs();
+    mutex.lock();
+    holdStartUs = statsNowUs();
+    lockWait.record(holdStartUs - requested);
+}
+
+void Marketplace::unlock() {
+    lockHold.record(statsNowUs() - holdStartUs);
+    mutex.unlock();
+}
+
+void Marketplace::postAsk(Seller* seller, ItemType item, int qty) {
+    if (qty <= 0) {
+        return;
+    }
+
+    lock(); // Début S.C.
+    Book& book = books[static_cast<std::size_t>(item)];
+    auto ask = std::find_if(book.asks.begin(), book.asks.end(),
+                            [seller](const Ask& a) { return a.seller == seller; });
+    if (ask != book.asks.end()) {
+        ask->qty += qty;
+    } else {
+        book.asks.push_back({seller, qty});
+    }
+    dirty = true;
+    cond.notifyOne();
+    unlock(); // Fin S.C.
+}
+
+void Marketplace::postBid(Seller* buyer, ItemType item, int qty, const std::vector<Seller*>* suppliers) {
+    escrow += getCostPerUnit(item) * qty;
+    EventLog::record(EventKind::Bid, buyer->getUniqueId(), -1, item, qty, getCostPerUnit(item) * qty);
+
+    lock(); // Début S.C.
+    books[static_cast<std::size_t>(item)].bids.push_back({buyer, qty, suppliers});
+    dirty = true;
+    cond.notifyOne();
+    unlock(); // Fin S.C.
+}
+
+ItemsForSale Marketplace::getOffers(const std::vector<Seller*>& suppliers) {
+    ItemsForSale offers{};
+
+    lock(); // Début S.C.
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        for (const Ask& ask : books[i].asks) {
+            if (std::find(suppliers.begin(), suppliers.end(), ask.seller) != suppliers.end()) {
+                offers[i] += ask.qty;
+            }
+        }
+    }
+    unlock(); // Fin S.C.
+
+    return offers;
+}
+
+void Marketplace::match(ItemType item, Book& book) {
+    for (auto bid = book.bids.begin(); bid != book.bids.end();) {
+        const std::vector<Seller*>& suppliers = *bid->suppliers;
+
+        for (auto ask = book.asks.begin(); ask != book.asks.end() && bid->qty > 0;) {
+            if (std::find(suppliers.begin(), suppliers.end(), ask->seller) == suppliers.end()) {
+                ++ask;
+                continue;
+            }
+
+            int qty = std::min(bid->qty, ask->qty);
+            fills.push_back({ask->seller, bid->buyer, item, qty});
+            bid->qty -= qty;
+            ask->qty -= qty;
+
+            if (ask->qty == 0) {
+                ask = book.asks.erase(ask);
+            } else {
+                ++ask;
+            }
+        }
+
+        if (bid->qty == 0) {
+            bid = book.bids.erase(bid);
+        } else {
+            ++bid;
+        }
+    }
+}
+
+void Marketplace::execute(const Fill& fill) {
+    /* Le vendeur est crédité avant que le séquestre ne soit libéré */
+    LedgerTransfer transfer;
+    int price = getCostPerUnit(fill.item) * fill.qty;
+    int bill = fill.seller->trade(fill.item, fill.qty);
+
+    escrow -= price;
+
+    if (bill == 0) {
+        /* Ne devrait pas arriver : l'offre de vente ne dépasse jamais le stock */
+        ++nbFailedTrades;
+        EventLog::record(EventKind::Refund, fill.buyer->getUniqueId(), -1, fill.item, fill.qty, price);
+        fill.buyer->refund(fill.item, fill.qty, price);
+        return;
+    }
+
+    ++nbFills;
+    EventLog::record(EventKind::Fill, fill.seller->getUniqueId(), fill.buyer->getUniqueId(), fill.item, fill.qty, price);
+    fill.buyer->deliver(fill.item, fill.qty);
+}
+
+void Marketplace::run() {
+    while (true) {
+        lock(); // Début S.C.
+        while (!dirty && !stopping) {
+            /* Le verrou est relâché pendant l'attente : elle ne compte pas comme détention */
+            lockHold.record(statsNowUs() - holdStartUs);
+            cond.wait(&mutex);
+            holdStartUs = statsNowUs();
+        }
+        if (stopping) {
+            unlock(); // Fin S.C.
+            break;
+        }
+        dirty = false;
+        fills.clear();
+        for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+            match(static_cast<ItemType>(i), books[i]);
+        }
+        unlock(); // Fin S.C.
+
+        /* Les ventes se font hors de la section critique, trade() étant sans verrou */
+        for (const Fill& fill : fills) {
+            execute(fill);
+        }
+    }
+}
+
+void Marketplace::stop() {
+    lock(); // Début S.C.
+    stopping = true;
+    cond.notifyAll();
+    unlock(); // Fin S.C.
+}
+
+void Marketplace::refundPendingBids() {
+    lock(); // Début S.C.
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        ItemType item = static_cast<ItemType>(i);
+        for (const Bid& bid : books[i].bids) {
+            int amount = getCostPerUnit(item) * bid.qty;
+            LedgerTransfer transfer;
+            escrow -= amount;
+            EventLog::record(EventKind::Refund, bid.buyer->getUniqueId(), -1, item, bid.qty, amount);
+            bid.buyer->refund(item, bid.qty, amount);
+        }
+        books[i].bids.clear();
+        books[i].asks.clear();
+    }
+    unlock(); // Fin S.C.
+}
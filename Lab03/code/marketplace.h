@@ -0,0 +1,155 @@
+#ifndef MARKETPLACE_H
+#define MARKETPLACE_H
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+#include "itemtype.h"
+#include "sellerstats.h"
+
+class Seller;
+
+/**
+ * @brief Place de marché centrale : un carnet d'ordres par type d'objet.
+ *
+ * Les vendeurs (mines, usines, grossistes) y annoncent leurs stocks par des offres de
+ * vente (asks), les acheteurs (grossistes, usines) y déposent des offres d'achat (bids)
+ * dont le montant a déjà été prélevé sur leurs fonds et est conservé en séquestre.
+ * Un thread dédié apparie les offres dans l'ordre d'arrivée, en ne considérant pour
+ * chaque acheteur que les vendeurs avec lesquels il est relié. Comme une offre de
+ * vente ne dépasse jamais le stock du vendeur, chaque appariement aboutit à un
+ * `trade()` qui réussit.
+ */
+class Marketplace
+{
+public:
+    /**
+     * @brief Annonce qu'un vendeur a des objets supplémentaires à vendre
+     * @param seller Le vendeur
+     * @param item Le type d'objet
+     * @param qty La quantité ajoutée à l'offre
+     */
+    void postAsk(Seller* seller, ItemType item, int qty);
+
+    /**
+     * @brief Dépose une offre d'achat. L'acheteur doit avoir déjà prélevé le prix
+     *        (coût unitaire * qty) sur ses fonds ; ce montant est mis en séquestre.
+     * @param buyer L'acheteur, livré via Seller::deliver
+     * @param item Le type d'objet voulu
+     * @param qty La quantité voulue
+     * @param suppliers Les vendeurs auxquels l'acheteur a le droit d'acheter
+     */
+    void postBid(Seller* buyer, ItemType item, int qty, const std::vector<Seller*>* suppliers);
+
+    /**
+     * @brief Quantités actuellement offertes par un ensemble de vendeurs
+     * @param suppliers Les vendeurs considérés
+     * @return La quantité offerte pour chaque type d'objet
+     */
+    ItemsForSale getOffers(const std::vector<Seller*>& suppliers);
+
+    /**
+     * @brief Routine du thread d'appariement, jusqu'à l'appel de stop()
+     */
+    void run();
+
+    /**
+     * @brief Demande l'arrêt du thread d'appariement
+     */
+    void stop();
+
+    /**
+     * @brief Rembourse les offres d'achat restées sans suite.
+     *        À appeler une fois tous les vendeurs et le thread d'appariement arrêtés.
+     */
+    void refundPendingBids();
+
+    /**
+     * @brief Montant actuellement en séquestre (offres d'achat non servies)
+     */
+    int getEscrow() const { return escrow.load(); }
+
+    unsigned long long getNbFills() const { return nbFills.load(); }
+
+    /**
+     * @brief Nombre d'appariements dont le `trade()` a échoué (devrait rester nul)
+     */
+    unsigned long long getNbFailedTrades() const { return nbFailedTrades.load(); }
+
+    /**
+     * @brief Durées d'attente pour obtenir le verrou des carnets
+     */
+    const LatencyHistogram& getLockWait() const { return lockWait; }
+
+    /**
+     * @brief Durées de détention du verrou des carnets
+     */
+    const LatencyHistogram& getLockHold() const { return lockHold; }
+
+private:
+    struct Ask {
+        Seller* seller;
+        int qty;
+    };
+
+    struct Bid {
+        Seller* buyer;
+        int qty;
+        const std::vector<Seller*>* suppliers;
+    };
+
+    struct Book {
+        std::deque<Ask> asks;
+        std::deque<Bid> bids;
+    };
+
+    struct Fill {
+        Seller* seller;
+        Seller* buyer;
+        ItemType item;
+        int qty;
+    };
+
+    /**
+     * @brief Apparie les offres d'un carnet, dans l'ordre d'arrivée (mutex tenu)
+     */
+    void match(ItemType item, Book& book);
+
+    /**
+     * @brief Exécute un appariement : vente, libération du séquestre et livraison
+     */
+    void execute(const Fill& fill);
+
+    /**
+     * @brief Prend le verrou des carnets en mesurant l'attente
+     */
+    void lock();
+
+    /**
+     * @brief Relâche le verrou des carnets en mesurant la détention
+     */
+    void unlock();
+
+    std::array<Book, NB_ITEM_TYPES> books;
+    // Appariements en attente d'exécution, réutilisé d'un tour à l'autre
+    std::vector<Fill> fills;
+
+    std::atomic<int> escrow{0};
+    std::atomic<unsigned long long> nbFills{0};
+    std::atomic<unsigned long long> nbFailedTrades{0};
+
+    LatencyHistogram lockWait;
+    LatencyHistogram lockHold;
+    // Instant de prise du verrou, lu et écrit par son seul détenteur
+    std::uint64_t holdStartUs = 0;
+
+    bool dirty = false;
+    bool stopping = false;
+    PcoMutex mutex;
+    PcoConditionVariable cond;
+};
+
+#endif // MARKETPLACE_H
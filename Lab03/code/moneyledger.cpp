@@ -0,0 +1,59 @@
+/**
+ * @file moneyledger.cpp
+ * @brief Compteurs de transferts en cours, répartis par thread, pour l'audit des fonds.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "moneyledger.h"
+
+std::array<MoneyLedger::Shard, LEDGER_NB_SHARDS> MoneyLedger::shards;
+
+namespace {
+std::atomic<unsigned> nextShard{0};
+thread_local int shardIndex = -1;
+}
+
+MoneyLedger::Shard& MoneyLedger::threadShard() {
+    if (shardIndex < 0) {
+        shardIndex = int(nextShard++ % LEDGER_NB_SHARDS);
+    }
+    return shards[std::size_t(shardIndex)];
+}
+
+void MoneyLedger::beginTransfer() {
+    threadShard().inFlight.fetch_add(1);
+}
+
+void MoneyLedger::endTransfer() {
+    Shard& shard = threadShard();
+    /* La génération change avant que le transfert ne quitte les compteurs en cours */
+    shard.generation.fetch_add(1);
+    shard.inFlight.fetch_sub(1);
+}
+
+MoneyLedger::Stamp MoneyLedger::stamp() {
+    Stamp result;
+    result.quiescent = true;
+
+    for (std::size_t i = 0; i < LEDGER_NB_SHARDS; ++i) {
+        result.generations[i] = shards[i].generation.load();
+        if (shards[i].inFlight.load() != 0) {
+            result.quiescent = false;
+        }
+    }
+    return result;
+}
+
+bool MoneyLedger::unchangedSince(const Stamp& before) {
+    if (!before.quiescent) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < LEDGER_NB_SHARDS; ++i) {
+        if (shards[i].inFlight.load() != 0 || shards[i].generation.load() != before.generations[i]) {
+            return false;
+        }
+    }
+    return true;
+}
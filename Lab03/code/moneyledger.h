@@ -0,0 +1,73 @@
+#ifndef MONEYLEDGER_H
+#define MONEYLEDGER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "itemtype.h"
+
+// Nombre de compteurs entre lesquels les threads se répartissent
+#define LEDGER_NB_SHARDS 64
+
+/**
+ * @brief Marquage des transferts d'argent en plusieurs étapes.
+ *
+ * Un échange débite l'acheteur et crédite le vendeur par deux opérations atomiques
+ * distinctes ; entre les deux, la somme des fonds est fausse. Chaque transfert de ce
+ * genre est encadré par un LedgerTransfer, qui incrémente le compteur de transferts en
+ * cours de la tranche du thread, puis, à la fin, sa génération.
+ *
+ * Un lecteur obtient un état cohérent à la manière d'un seqlock : il relève les
+ * générations, vérifie qu'aucun transfert n'est en cours, lit les fonds, puis vérifie
+ * que rien n'a bougé. Les transferts ne l'attendent jamais ; c'est lui qui recommence.
+ */
+class MoneyLedger {
+public:
+    /**
+     * @brief Relevé de l'état des tranches, à comparer avant et après une lecture
+     */
+    struct Stamp {
+        std::array<std::uint64_t, LEDGER_NB_SHARDS> generations;
+        // Aucun transfert n'était en cours lors du relevé
+        bool quiescent;
+    };
+
+    static void beginTransfer();
+    static void endTransfer();
+
+    /**
+     * @brief Relève les générations et vérifie qu'aucun transfert n'est en cours
+     */
+    static Stamp stamp();
+
+    /**
+     * @brief Vérifie qu'une lecture faite depuis le relevé est cohérente
+     * @param before Le relevé pris avant la lecture
+     * @return true si aucun transfert n'était en cours ni ne s'est produit entretemps
+     */
+    static bool unchangedSince(const Stamp& before);
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<int> inFlight{0};
+        std::atomic<std::uint64_t> generation{0};
+    };
+
+    static Shard& threadShard();
+
+    static std::array<Shard, LEDGER_NB_SHARDS> shards;
+};
+
+/**
+ * @brief Encadre un transfert d'argent pour la durée d'un bloc
+ */
+class LedgerTransfer {
+public:
+    LedgerTransfer() { MoneyLedger::beginTransfer(); }
+    ~LedgerTransfer() { MoneyLedger::endTransfer(); }
+
+    LedgerTransfer(const LedgerTransfer&) = delete;
+    LedgerTransfer& operator=(const LedgerTransfer&) = delete;
+};
+
+#endif // MONEYLEDGER_H
@@ -0,0 +1,420 @@
+/**
+ * @file partition.cpp
+ * @brief Processus de la simulation répartie, connexions et appels distants.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "partition.h"
+#include "moneyledger.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Ferme les descripteurs déjà ouverts d'un tableau de paires
+ */
+template<typename Pairs>
+void closePairs(Pairs& pairs) {
+    for (auto& pair : pairs) {
+        for (int fd : pair) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+}
+
+bool writeAll(int fd, const void* data, std::size_t size) {
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= std::size_t(written);
+    }
+    return true;
+}
+
+/**
+ * @return false si la connexion est fermée ou rompue avant que tout soit lu
+ */
+bool readAll(int fd, void* data, std::size_t size) {
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t nbRead = ::read(fd, bytes, size);
+        if (nbRead < 0 && errno == EINTR) {
+            continue;
+        }
+        if (nbRead <= 0) {
+            return false;
+        }
+        bytes += nbRead;
+        size -= std::size_t(nbRead);
+    }
+    return true;
+}
+
+} // namespace
+
+RemoteSeller::RemoteSeller(int uniqueId, Partition* partition) : Seller(0, uniqueId), partition(partition) {}
+
+ItemsForSale RemoteSeller::getItemsForSale() {
+    RemoteRequest request{};
+    request.call = RemoteRequest::Call::ItemsForSale;
+    request.sellerId = uniqueId;
+
+    RemoteReply reply{};
+    if (!partition->call(request, reply)) {
+        return ItemsForSale{};
+    }
+    return reply.items;
+}
+
+int RemoteSeller::trade(ItemType what, int qty) {
+    RemoteRequest request{};
+    request.call = RemoteRequest::Call::Trade;
+    request.sellerId = uniqueId;
+    request.nbLines = 1;
+    request.lines[0] = {what, qty, 0};
+
+    RemoteReply reply{};
+    if (!partition->call(request, reply)) {
+        return 0;
+    }
+    /* L'acheteur débite la facture dans le transfert en cours */
+    partition->paidToPeers += reply.bill;
+    return reply.bill;
+}
+
+int RemoteSeller::tradeBatch(Order& order, BatchMode mode) {
+    RemoteRequest request{};
+    request.call = RemoteRequest::Call::TradeBatch;
+    request.sellerId = uniqueId;
+    request.mode = mode;
+    request.nbLines = std::int32_t(order.nbLines);
+    request.lines = order.lines;
+
+    RemoteReply reply{};
+    if (!partition->call(request, reply)) {
+        return 0;
+    }
+    for (std::size_t i = 0; i < order.nbLines; ++i) {
+        order.lines[i].delivered = reply.delivered[i];
+        order.lines[i].unitPrice = reply.unitPrices[i];
+    }
+    partition->paidToPeers += reply.bill;
+    return reply.bill;
+}
+
+void RemoteSeller::subscribeRestock(ItemType item, Wakeup* subscriber) {
+    Seller::subscribeRestock(item, subscriber);
+    watched = true;
+}
+
+void RemoteSeller::pollRestocks() {
+    RemoteRequest request{};
+    request.call = RemoteRequest::Call::ItemsForSale;
+    request.sellerId = uniqueId;
+
+    RemoteReply reply{};
+    if (!partition->call(request, reply, true)) {
+        return;
+    }
+    const ItemsForSale& items = reply.items;
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        if (items[i] > lastItems[i]) {
+            restocks.publish(static_cast<ItemType>(i));
+        }
+    }
+    lastItems = items;
+}
+
+Partition::Partition(unsigned index, unsigned nbPartitions)
+    : index(index), nbPartitions(nbPartitions), clients(nbPartitions) {}
+
+Partition::~Partition() {
+    close();
+    for (int fd : servers) {
+        ::close(fd);
+    }
+    for (int fd : childPipes) {
+        ::close(fd);
+    }
+    if (summaryPipe >= 0) {
+        ::close(summaryPipe);
+    }
+}
+
+std::unique_ptr<Partition> Partition::spawn(unsigned nbPartitions) {
+    if (nbPartitions < 1 || nbPartitions > PARTITION_MAX) {
+        std::cerr << "The number of processes must be between 1 and " << PARTITION_MAX << std::endl;
+        return nullptr;
+    }
+
+    /* sockets[client][server][k] : [0] côté client, [1] côté serveur */
+    std::vector<std::vector<std::array<std::array<int, 2>, PARTITION_CHANNELS_PER_PEER>>> sockets(
+        nbPartitions, std::vector<std::array<std::array<int, 2>, PARTITION_CHANNELS_PER_PEER>>(nbPartitions));
+    std::vector<std::array<int, 2>> pipes(nbPartitions, {-1, -1});
+    for (auto& row : sockets) {
+        for (auto& channels : row) {
+            channels.fill({-1, -1});
+        }
+    }
+
+    /* Échec avant ou pendant les fork : aucun enfant ne doit survivre au principal */
+    auto abandon = [&sockets, &pipes](const std::vector<int>& childPids) {
+        for (int pid : childPids) {
+            ::kill(pid, SIGKILL);
+            ::waitpid(pid, nullptr, 0);
+        }
+        for (auto& row : sockets) {
+            for (auto& channels : row) {
+                closePairs(channels);
+            }
+        }
+        closePairs(pipes);
+        return nullptr;
+    };
+
+    for (unsigned client = 0; client < nbPartitions; ++client) {
+        for (unsigned server = 0; server < nbPartitions; ++server) {
+            for (auto& pair : sockets[client][server]) {
+                if (client != server && ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair.data()) < 0) {
+                    std::cerr << "Cannot create the connections between processes" << std::endl;
+                    pair = {-1, -1};
+                    return abandon({});
+                }
+            }
+        }
+        if (client > 0 && ::pipe2(pipes[client].data(), O_CLOEXEC) < 0) {
+            std::cerr << "Cannot create the connections between processes" << std::endl;
+            pipes[client] = {-1, -1};
+            return abandon({});
+        }
+    }
+
+    /* Le processus principal est la partition 0, chaque enfant prend l'indice suivant */
+    unsigned index = 0;
+    std::vector<int> childPids;
+    for (unsigned child = 1; child < nbPartitions; ++child) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            std::cerr << "Cannot start process " << child << std::endl;
+            return abandon(childPids);
+        }
+        if (pid == 0) {
+            index = child;
+            childPids.clear();
+            break;
+        }
+        childPids.push_back(int(pid));
+    }
+
+    std::unique_ptr<Partition> partition(new Partition(index, nbPartitions));
+    partition->childPids = childPids;
+
+    /* Chaque processus garde ses extrémités et ferme toutes les autres */
+    for (unsigned client = 0; client < nbPartitions; ++client) {
+        for (unsigned server = 0; server < nbPartitions; ++server) {
+            for (auto& pair : sockets[client][server]) {
+                if (pair[0] < 0) {
+                    continue;
+                }
+                if (client == index) {
+                    auto channel = std::make_unique<Channel>();
+                    channel->fd = pair[0];
+                    partition->clients[server].push_back(std::move(channel));
+                } else {
+                    ::close(pair[0]);
+                }
+                if (server == index) {
+                    partition->servers.push_back(pair[1]);
+                } else {
+                    ::close(pair[1]);
+                }
+            }
+        }
+        if (client > 0) {
+            if (index == 0) {
+                partition->childPipes.push_back(pipes[client][0]);
+            } else {
+                ::close(pipes[client][0]);
+            }
+            if (index == client) {
+                partition->summaryPipe = pipes[client][1];
+            } else {
+                ::close(pipes[client][1]);
+            }
+        }
+    }
+
+    if (index > 0) {
+        int devNull = ::open("/dev/null", O_WRONLY);
+        if (devNull >= 0) {
+            std::cout.flush();
+            ::dup2(devNull, STDOUT_FILENO);
+            ::close(devNull);
+        }
+    }
+
+    return partition;
+}
+
+RemoteSeller* Partition::createProxy(int sellerId) {
+    proxies.push_back(std::make_unique<RemoteSeller>(sellerId, this));
+    return proxies.back().get();
+}
+
+void Partition::serve(const std::vector<Seller*>& sellersById) {
+    this->sellersById = sellersById;
+
+    for (int fd : servers) {
+        serverThreads.emplace_back(std::make_unique<PcoThread>(&Partition::serveChannel, this, fd));
+    }
+    restockThread = std::make_unique<PcoThread>(&Partition::pollRestocks, this);
+}
+
+void Partition::close() {
+    if (restockThread) {
+        restockThread->requestStop();
+        restockThread->join();
+        restockThread.reset();
+    }
+
+    /* Les serveurs des autres processus voient la fin de leurs connexions */
+    for (auto& channels : clients) {
+        for (auto& channel : channels) {
+            channel->mutex.lock();
+            if (channel->fd >= 0) {
+                ::close(channel->fd);
+                channel->fd = -1;
+            }
+            channel->mutex.unlock();
+        }
+    }
+
+    for (auto& thread : serverThreads) {
+        thread->join();
+    }
+    serverThreads.clear();
+}
+
+bool Partition::call(const RemoteRequest& request, RemoteReply& reply, bool poll) {
+    /* Chaque thread appelant garde la même connexion vers un processus donné */
+    static thread_local unsigned slot = nbCallers.fetch_add(1) % PARTITION_CHANNELS_PER_PEER;
+
+    Channel& channel = *clients[unsigned(request.sellerId) % nbPartitions][slot];
+    auto start = std::chrono::steady_clock::now();
+
+    channel.mutex.lock(); // Début S.C.
+    bool answered = channel.fd >= 0 && writeAll(channel.fd, &request, sizeof(request)) &&
+                    readAll(channel.fd, &reply, sizeof(reply));
+    channel.mutex.unlock(); // Fin S.C.
+
+    if (poll) {
+        nbRestockPolls.fetch_add(1, std::memory_order_relaxed);
+        return answered;
+    }
+    nbRemoteCalls.fetch_add(1, std::memory_order_relaxed);
+    remoteCallNs.fetch_add(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start).count()),
+                           std::memory_order_relaxed);
+    return answered;
+}
+
+void Partition::serveChannel(int fd) {
+    RemoteRequest request;
+
+    while (readAll(fd, &request, sizeof(request))) {
+        RemoteReply reply{};
+        Seller* seller = nullptr;
+        if (request.sellerId >= 0 && std::size_t(request.sellerId) < sellersById.size() && owns(request.sellerId)) {
+            seller = sellersById[std::size_t(request.sellerId)];
+        }
+
+        if (seller) {
+            switch (request.call) {
+            case RemoteRequest::Call::ItemsForSale:
+                reply.items = seller->getItemsForSale();
+                break;
+            case RemoteRequest::Call::Trade: {
+                /* Le vendeur est crédité ; l'argent vient d'un autre processus */
+                LedgerTransfer transfer;
+                reply.bill = seller->trade(request.lines[0].item, request.lines[0].qty);
+                receivedFromPeers += reply.bill;
+                break;
+            }
+            case RemoteRequest::Call::TradeBatch: {
+                Order order;
+                order.lines = request.lines;
+                order.nbLines = std::min<std::size_t>(std::size_t(std::max(request.nbLines, 0)), NB_ITEM_TYPES);
+                LedgerTransfer transfer;
+                reply.bill = seller->tradeBatch(order, request.mode);
+                receivedFromPeers += reply.bill;
+                for (std::size_t i = 0; i < order.nbLines; ++i) {
+                    reply.delivered[i] = order.lines[i].delivered;
+                    reply.unitPrices[i] = order.lines[i].unitPrice;
+                }
+                break;
+            }
+            }
+        }
+
+        if (!writeAll(fd, &reply, sizeof(reply))) {
+            break;
+        }
+    }
+}
+
+void Partition::pollRestocks() {
+    while (!PcoThread::thisThread()->stopRequested()) {
+        for (auto& proxy : proxies) {
+            if (proxy->watched) {
+                proxy->pollRestocks();
+            }
+        }
+        PcoThread::usleep(PARTITION_RESTOCK_POLL_US);
+    }
+}
+
+std::vector<PartitionSummary> Partition::exchangeSummaries(PartitionSummary local) {
+    local.paidToPeers = paidToPeers.load();
+    local.receivedFromPeers = receivedFromPeers.load();
+    local.nbRemoteCalls = nbRemoteCalls.load();
+    local.remoteCallNs = remoteCallNs.load();
+    local.nbRestockPolls = nbRestockPolls.load();
+
+    std::vector<PartitionSummary> summaries{local};
+
+    if (!isMain()) {
+        if (!writeAll(summaryPipe, &local, sizeof(local))) {
+            std::cerr << "Process " << index << " cannot send its summary" << std::endl;
+        }
+        return summaries;
+    }
+
+    for (std::size_t child = 0; child < childPipes.size(); ++child) {
+        PartitionSummary summary;
+        if (readAll(childPipes[child], &summary, sizeof(summary))) {
+            summaries.push_back(summary);
+        } else {
+            std::cerr << "Process " << child + 1 << " ended without a summary" << std::endl;
+        }
+        ::waitpid(childPids[child], nullptr, 0);
+    }
+    childPids.clear();
+    return summaries;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file partition.h
+ * @brief Répartition des vendeurs entre plusieurs processus d'une même machine,
+ *        échanges entre processus par sockets Unix.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcothread.h>
+#include "seller.h"
+
+// Nombre maximal de processus, borné par le nombre de sockets ouvertes avant les fork
+#define PARTITION_MAX 8
+// Connexions d'un processus vers chacun des autres, pour que ses threads n'attendent pas tous la même
+#define PARTITION_CHANNELS_PER_PEER 4
+// Temps réel entre deux relevés des stocks des vendeurs distants surveillés (µs)
+#define PARTITION_RESTOCK_POLL_US 1000
+
+class Partition;
+
+/**
+ * @brief Appel d'un vendeur distant, de taille fixe
+ */
+struct RemoteRequest {
+    enum class Call : std::int32_t {ItemsForSale, Trade, TradeBatch};
+
+    Call call;
+    std::int32_t sellerId;
+    BatchMode mode;
+    std::int32_t nbLines;
+    // Trade : l'objet et la quantité sont dans la première ligne
+    std::array<OrderLine, NB_ITEM_TYPES> lines;
+};
+
+/**
+ * @brief Réponse à un RemoteRequest
+ */
+struct RemoteReply {
+    std::int32_t bill;
+    std::array<std::int32_t, NB_ITEM_TYPES> delivered;
+    std::array<std::int32_t, NB_ITEM_TYPES> unitPrices;
+    ItemsForSale items;
+};
+
+/**
+ * @brief Bilan d'un processus, envoyé au processus principal à la fin de la simulation
+ */
+struct PartitionSummary {
+    long long startFund = 0;
+    // Fonds, salaires et argent échangé avec les autres processus ; égal à startFund si conservé
+    long long endFund = 0;
+    long long paidToPeers = 0;
+    long long receivedFromPeers = 0;
+    std::uint64_t nbSold = 0;
+    // Appels des vendeurs (consultations des stocks et achats), relevés des réassorts à part
+    std::uint64_t nbRemoteCalls = 0;
+    std::uint64_t remoteCallNs = 0;
+    std::uint64_t nbRestockPolls = 0;
+};
+
+/**
+ * @brief Représentant local d'un vendeur d'un autre processus.
+ *
+ * Chaque appel devient une requête sur une connexion vers le processus propriétaire,
+ * dont la réponse est attendue : l'acheteur paie la facture reçue comme pour un vendeur
+ * local. Les abonnements au réassort restent locaux ; la partition relève les stocks
+ * du vendeur distant et prévient les abonnés quand ils augmentent. Le représentant
+ * n'a pas de routine et ne possède ni fonds ni stocks.
+ */
+class RemoteSeller : public Seller
+{
+public:
+    RemoteSeller(int uniqueId, Partition* partition);
+
+    ItemsForSale getItemsForSale() override;
+    int trade(ItemType what, int qty) override;
+    int tradeBatch(Order& order, BatchMode mode) override;
+
+    void subscribeRestock(ItemType item, Wakeup* subscriber) override;
+
+    bool start() override { return false; }
+    Step step() override { return Step::wait(); }
+    void finish() override {}
+
+private:
+    friend class Partition;
+
+    /**
+     * @brief Relève les stocks du vendeur distant et prévient les abonnés de ceux qui ont augmenté
+     */
+    void pollRestocks();
+
+    Partition* partition;
+    // Des abonnés attendent le réassort de ce vendeur
+    bool watched = false;
+    // Stocks lors du dernier relevé, lus et écrits par le seul thread de relevé
+    ItemsForSale lastItems{};
+};
+
+/**
+ * @brief Place de ce processus parmi ceux qui se partagent la simulation.
+ *
+ * Le vendeur d'identifiant `id` appartient au processus `id % nombre de processus`.
+ * Tous les processus construisent le même réseau d'échanges (même graine) ; chacun
+ * exécute ses vendeurs et remplace les autres par des RemoteSeller. Les connexions
+ * sont des paires de sockets Unix créées avant les fork : pour chaque couple
+ * (client, serveur), PARTITION_CHANNELS_PER_PEER connexions, chacune servie par un
+ * thread du serveur qui exécute les appels sur ses vendeurs.
+ *
+ * Les threads serveurs ne font jamais d'appel distant, si bien qu'un appel finit
+ * toujours par être servi. Un processus qui a arrêté ses vendeurs ferme ses connexions
+ * clientes, puis sert les autres jusqu'à ce qu'ils en aient fait autant : ses fonds ne
+ * bougent plus quand il fait son bilan.
+ */
+class Partition
+{
+public:
+    /**
+     * @brief Crée les connexions puis les nbPartitions - 1 processus enfants.
+     *        À appeler avant de lancer le moindre thread. La sortie standard des enfants
+     *        est fermée : seul le processus principal écrit le rapport.
+     * @return La partition du processus appelant, nullptr si une connexion ou un fork a échoué
+     */
+    static std::unique_ptr<Partition> spawn(unsigned nbPartitions);
+
+    ~Partition();
+
+    unsigned getIndex() const { return index; }
+    unsigned getNbPartitions() const { return nbPartitions; }
+    bool isMain() const { return index == 0; }
+
+    bool owns(int sellerId) const { return unsigned(sellerId) % nbPartitions == index; }
+
+    /**
+     * @brief Crée le représentant d'un vendeur d'un autre processus, détenu par la partition
+     */
+    RemoteSeller* createProxy(int sellerId);
+
+    /**
+     * @brief Lance les threads serveurs et le thread de relevé des réassorts
+     * @param sellersById Les vendeurs de la simulation par identifiant ; seuls ceux du processus sont servis
+     */
+    void serve(const std::vector<Seller*>& sellersById);
+
+    /**
+     * @brief Ferme les connexions clientes et attend que les autres processus ferment les leurs.
+     *        À appeler une fois les vendeurs du processus arrêtés.
+     */
+    void close();
+
+    /**
+     * @brief Argent payé aux vendeurs distants moins celui reçu d'acheteurs distants,
+     *        à ajouter aux fonds locaux pour vérifier leur conservation
+     */
+    long long getNetPaidToPeers() const { return paidToPeers.load() - receivedFromPeers.load(); }
+
+    /**
+     * @brief Complète le bilan local des échanges avec les autres processus, puis :
+     *        un enfant l'envoie au processus principal ; le principal reçoit ceux des
+     *        enfants et attend leur fin.
+     * @param local Le bilan des vendeurs du processus (fonds et ventes)
+     * @return Les bilans de tous les processus dans le principal, le bilan local dans un enfant
+     */
+    std::vector<PartitionSummary> exchangeSummaries(PartitionSummary local);
+
+private:
+    friend class RemoteSeller;
+
+    struct Channel {
+        int fd = -1;
+        PcoMutex mutex;
+    };
+
+    Partition(unsigned index, unsigned nbPartitions);
+
+    /**
+     * @brief Envoie un appel au processus propriétaire du vendeur et attend la réponse
+     * @param poll L'appel est un relevé des réassorts, compté à part des appels des vendeurs
+     * @return false si la connexion est rompue
+     */
+    bool call(const RemoteRequest& request, RemoteReply& reply, bool poll = false);
+
+    /**
+     * @brief Routine d'un thread serveur : exécute les appels reçus sur une connexion jusqu'à sa fermeture
+     */
+    void serveChannel(int fd);
+
+    /**
+     * @brief Routine du thread de relevé des réassorts des vendeurs distants surveillés
+     */
+    void pollRestocks();
+
+    const unsigned index;
+    const unsigned nbPartitions;
+
+    // Connexions clientes vers chaque processus (vide pour soi-même)
+    std::vector<std::vector<std::unique_ptr<Channel>>> clients;
+    // Connexions servies par ce processus
+    std::vector<int> servers;
+    // Enfants : tube vers le principal. Principal : tubes des enfants et leur pid
+    int summaryPipe = -1;
+    std::vector<int> childPipes;
+    std::vector<int> childPids;
+
+    std::vector<Seller*> sellersById;
+    std::vector<std::unique_ptr<RemoteSeller>> proxies;
+
+    std::vector<std::unique_ptr<PcoThread>> serverThreads;
+    std::unique_ptr<PcoThread> restockThread;
+
+    std::atomic<long long> paidToPeers{0};
+    std::atomic<long long> receivedFromPeers{0};
+    std::atomic<std::uint64_t> nbRemoteCalls{0};
+    std::atomic<std::uint64_t> remoteCallNs{0};
+    std::atomic<std::uint64_t> nbRestockPolls{0};
+    std::atomic<unsigned> nbCallers{0};
+};
+
+#endif // PARTITION_H
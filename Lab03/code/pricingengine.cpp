@@ -0,0 +1,95 @@
+/**
+ * @file pricingengine.cpp
+ * @brief Comptage sans verrou de l'offre et de la demande, ajustement des prix.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "pricingengine.h"
+#include "recipebook.h"
+#include "simulationclock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Les 40 bits de poids faible d'un compteur portent la quantité, les autres l'époque de sa tranche
+constexpr unsigned COUNT_BITS = 40;
+constexpr std::uint64_t COUNT_MASK = (std::uint64_t(1) << COUNT_BITS) - 1;
+
+/**
+ * @brief Marque d'époque d'un compteur ; jamais nulle, un compteur neuf n'appartient à aucune tranche
+ */
+std::uint64_t tagOf(std::uint64_t epoch) {
+    return (epoch + 1) << COUNT_BITS;
+}
+
+/**
+ * @brief Quantité comptée dans la tranche de l'époque donnée, 0 si le compteur en a changé depuis
+ */
+std::uint64_t countIn(const std::atomic<std::uint64_t>& counter, std::uint64_t epoch) {
+    std::uint64_t value = counter.load(std::memory_order_relaxed);
+    return (value & ~COUNT_MASK) == tagOf(epoch) ? value & COUNT_MASK : 0;
+}
+
+} // namespace
+
+std::atomic<PricingEngine*> PricingEngine::active{nullptr};
+
+PricingEngine::PricingEngine(const PricingConfig& config, SimulationClock* clock)
+    : config(config), clock(clock) {
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        items[i].price.store(recipeBook().costs[i]);
+    }
+}
+
+void PricingEngine::setActive(PricingEngine* engine) {
+    active.store(engine, std::memory_order_release);
+}
+
+void PricingEngine::record(ItemType item, int qty, Side side) {
+    if (qty <= 0 || item == ItemType::Nothing) {
+        return;
+    }
+
+    std::size_t i = static_cast<std::size_t>(item);
+    ItemState& state = items[i];
+    std::uint64_t epoch = clock->now() / config.bucketUs;
+
+    /* Nouvelle époque : un seul thread ajuste le prix, les autres comptent sans attendre */
+    std::uint64_t priced = state.pricedEpoch.load(std::memory_order_relaxed);
+    if (epoch > priced && state.pricedEpoch.compare_exchange_strong(priced, epoch)) {
+        reprice(i, epoch);
+    }
+
+    Bucket& bucket = state.buckets[epoch % PRICING_WINDOW_BUCKETS];
+    std::atomic<std::uint64_t>& counter = side == Side::Demand ? bucket.demand : bucket.supply;
+    std::uint64_t tag = tagOf(epoch);
+    std::uint64_t current = counter.load(std::memory_order_relaxed);
+    std::uint64_t next;
+    do {
+        /* Tranche d'une époque révolue : elle repart de zéro */
+        next = (current & ~COUNT_MASK) == tag ? current + std::uint64_t(qty) : tag | std::uint64_t(qty);
+    } while (!counter.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+void PricingEngine::reprice(std::size_t item, std::uint64_t epoch) {
+    ItemState& state = items[item];
+    std::uint64_t demand = 0;
+    std::uint64_t supply = 0;
+
+    for (std::uint64_t age = 1; age < PRICING_WINDOW_BUCKETS && age <= epoch; ++age) {
+        const Bucket& bucket = state.buckets[(epoch - age) % PRICING_WINDOW_BUCKETS];
+        demand += countIn(bucket.demand, epoch - age);
+        supply += countIn(bucket.supply, epoch - age);
+    }
+
+    double base = recipeBook().costs[item];
+    double target = base * std::pow((double(demand) + 1.0) / (double(supply) + 1.0), config.elasticity);
+    target = std::clamp(target, base * config.minFactor, base * config.maxFactor);
+
+    double current = state.price.load(std::memory_order_relaxed);
+    int price = int(std::lround(current + config.smoothing * (target - current)));
+    state.price.store(std::max(1, price), std::memory_order_relaxed);
+    ++nbRepricings;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file pricingengine.h
+ * @brief Prix des objets ajustés à l'offre et à la demande observées sur une fenêtre glissante.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef PRICINGENGINE_H
+#define PRICINGENGINE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "itemtype.h"
+
+class SimulationClock;
+
+// Nombre de tranches de la fenêtre glissante ; la tranche courante n'entre pas dans le calcul
+#define PRICING_WINDOW_BUCKETS 8
+
+/**
+ * @brief Réglages de la tarification dynamique
+ */
+struct PricingConfig {
+    // Prix ajustés à l'offre et à la demande ; sinon, prix fixes du catalogue
+    bool enabled = false;
+    // Durée d'une tranche de la fenêtre glissante (µs simulées)
+    std::uint64_t bucketUs = 1000000;
+    // Exposant appliqué au rapport demande / offre
+    double elasticity = 0.5;
+    // Bornes du prix, en multiples du prix du catalogue
+    double minFactor = 0.5;
+    double maxFactor = 3.0;
+    // Part de l'écart au prix visé comblée à chaque ajustement
+    double smoothing = 0.5;
+};
+
+/**
+ * @brief Moteur de tarification dynamique.
+ *
+ * Les quantités demandées (achats des grossistes couverts par leurs fonds, commandes des
+ * usines comptées une seule fois même redemandées) et offertes (objets extraits ou
+ * assemblés) sont comptées par type d'objet dans des tranches de temps simulé. Chaque compteur
+ * porte l'époque de sa tranche dans ses bits de poids fort : un ajout dans une tranche
+ * périmée la remet à zéro par le même compare-and-swap, sans verrou.
+ *
+ * Le premier thread qui compte un objet dans une nouvelle époque recalcule son prix à
+ * partir des tranches closes de la fenêtre et le publie ; les autres n'attendent pas.
+ * Lire un prix ne coûte qu'une lecture atomique.
+ */
+class PricingEngine
+{
+public:
+    /**
+     * @param config Les réglages
+     * @param clock L'horloge dont le temps simulé découpe la fenêtre
+     */
+    PricingEngine(const PricingConfig& config, SimulationClock* clock);
+
+    /**
+     * @brief Active ou désactive (nullptr) le moteur consulté par getCostPerUnit
+     */
+    static void setActive(PricingEngine* engine);
+
+    static PricingEngine* getActive() { return active.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Compte une quantité demandée auprès du moteur actif
+     */
+    static void recordDemand(ItemType item, int qty) {
+        PricingEngine* engine = getActive();
+        if (engine) {
+            engine->record(item, qty, Side::Demand);
+        }
+    }
+
+    /**
+     * @brief Compte une quantité mise en stock par une mine ou une usine auprès du moteur actif
+     */
+    static void recordSupply(ItemType item, int qty) {
+        PricingEngine* engine = getActive();
+        if (engine) {
+            engine->record(item, qty, Side::Supply);
+        }
+    }
+
+    /**
+     * @brief Prix unitaire courant
+     */
+    int getPrice(ItemType item) const {
+        return items[static_cast<std::size_t>(item)].price.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Nombre d'ajustements de prix depuis la création
+     */
+    std::uint64_t getNbRepricings() const { return nbRepricings.load(); }
+
+private:
+    enum class Side {Demand, Supply};
+
+    /**
+     * @brief Tranche de la fenêtre : époque dans les bits de poids fort de chaque compteur
+     */
+    struct Bucket {
+        std::atomic<std::uint64_t> demand{0};
+        std::atomic<std::uint64_t> supply{0};
+    };
+
+    /**
+     * @brief État d'un type d'objet, seul sur ses lignes de cache
+     */
+    struct alignas(CACHE_LINE_SIZE) ItemState {
+        std::array<Bucket, PRICING_WINDOW_BUCKETS> buckets;
+        std::atomic<int> price{0};
+        // Époque du dernier ajustement
+        std::atomic<std::uint64_t> pricedEpoch{0};
+    };
+
+    void record(ItemType item, int qty, Side side);
+
+    /**
+     * @brief Recalcule le prix d'un objet sur les tranches closes avant `epoch`
+     */
+    void reprice(std::size_t item, std::uint64_t epoch);
+
+    const PricingConfig config;
+    SimulationClock* clock;
+
+    std::array<ItemState, NB_ITEM_TYPES + 1> items;
+    std::atomic<std::uint64_t> nbRepricings{0};
+
+    static std::atomic<PricingEngine*> active;
+};
+
+#endif // PRICINGENGINE_H
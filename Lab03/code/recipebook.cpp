@@ -0,0 +1,262 @@
+/**
+ * @file recipebook.cpp
+ * @brief Lecture du catalogue des objets et compilation en tableaux plats.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "recipebook.h"
+#include "threadrandom.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+/*
+ * Catalogue intégré, lu comme un fichier passé à loadRecipeBook : ce sont les prix,
+ * salaires et recettes d'origine du laboratoire.
+ */
+const char* const BUILT_IN_RECIPES =
+    "#    objet    prix  métier       lot  durée min  durée max\n"
+    "item Sand     6     Extractor    1    10000      1000000\n"
+    "item Copper   5     Extractor    1    10000      1000000\n"
+    "item Petrol   5     Extractor    1    10000      1000000\n"
+    "item Chip     10    Electrician  1    0          9900000\n"
+    "item Plastic  7     Plasturgist  1    0          9900000\n"
+    "item Robot    15    Engineer     1    0          9900000\n"
+    "salary Extractor   4\n"
+    "salary Electrician 6\n"
+    "salary Plasturgist 5\n"
+    "salary Engineer    7\n"
+    "recipe Plastic Petrol 1\n"
+    "recipe Chip    Sand 1 Copper 1\n"
+    "recipe Robot   Chip 1 Plastic 1\n";
+
+// Noms reconnus dans les fichiers, dans l'ordre des énumérations
+const char* const ITEM_NAMES[NB_ITEM_TYPES] = {"Sand", "Copper", "Petrol", "Chip", "Plastic", "Robot"};
+const char* const EMPLOYEE_NAMES[NB_EMPLOYEE_TYPES] = {"Extractor", "Electrician", "Plasturgist", "Engineer"};
+
+/**
+ * @brief Catalogue en cours de lecture, avant sa compilation en tableaux plats
+ */
+struct Draft {
+    RecipeBook scalars;
+    std::array<std::vector<Ingredient>, NB_ITEM_TYPES> recipes;
+    // Objets dans l'ordre de leur première directive `recipe`, qui est celui des usines
+    std::vector<ItemType> recipeOrder;
+};
+
+bool parseItem(const std::string& name, ItemType& item) {
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        if (name == ITEM_NAMES[i]) {
+            item = static_cast<ItemType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseEmployee(const std::string& name, EmployeeType& employee) {
+    for (std::size_t i = 0; i < NB_EMPLOYEE_TYPES; ++i) {
+        if (name == EMPLOYEE_NAMES[i]) {
+            employee = static_cast<EmployeeType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Applique au brouillon les directives lues
+ */
+bool parse(std::istream& in, const std::string& source, Draft& draft) {
+    RecipeBook& book = draft.scalars;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::istringstream words(line);
+        std::string directive;
+        if (!(words >> directive) || directive[0] == '#') {
+            continue;
+        }
+
+        std::string name;
+        words >> name;
+        ItemType item;
+        EmployeeType employee;
+        bool valid = true;
+
+        if (directive == "item") {
+            valid = parseItem(name, item);
+            if (valid) {
+                std::size_t i = RecipeBook::index(item);
+                std::string producer;
+                /* Lues signées : une durée négative serait sinon ramenée modulo 2^32 */
+                long long minUs = 0;
+                long long maxUs = 0;
+                valid = words >> book.costs[i] >> producer >> book.batchSizes[i] >> minUs >> maxUs &&
+                        parseEmployee(producer, book.producers[i]) &&
+                        minUs >= 0 && maxUs >= 0 && minUs <= maxUs &&
+                        maxUs <= std::numeric_limits<std::uint32_t>::max();
+                if (valid) {
+                    book.buildTimeMinUs[i] = std::uint32_t(minUs);
+                    book.buildTimeMaxUs[i] = std::uint32_t(maxUs);
+                }
+            }
+        } else if (directive == "salary") {
+            valid = parseEmployee(name, employee) &&
+                    words >> book.salaries[static_cast<std::size_t>(employee)];
+        } else if (directive == "recipe") {
+            valid = parseItem(name, item);
+            if (valid) {
+                std::vector<Ingredient>& recipe = draft.recipes[RecipeBook::index(item)];
+                recipe.clear();
+                if (std::find(draft.recipeOrder.begin(), draft.recipeOrder.end(), item) == draft.recipeOrder.end()) {
+                    draft.recipeOrder.push_back(item);
+                }
+                std::string ingredient;
+                while (valid && words >> ingredient) {
+                    Ingredient entry;
+                    valid = parseItem(ingredient, entry.item) && words >> entry.qty && entry.qty > 0;
+                    for (const Ingredient& other : recipe) {
+                        valid = valid && other.item != entry.item;
+                    }
+                    recipe.push_back(entry);
+                }
+            }
+        } else {
+            std::cerr << source << ":" << lineNumber << ": unknown directive " << directive << std::endl;
+            return false;
+        }
+
+        std::string extra;
+        if (!valid || words >> extra) {
+            std::cerr << source << ":" << lineNumber << ": invalid " << directive << " line" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Vrai si la recette de l'objet dépend, même indirectement, d'un objet en cours de visite
+ * @param state 0 : non visité, 1 : en cours de visite, 2 : sans cycle
+ */
+bool hasCycle(const Draft& draft, std::size_t item, std::array<int, NB_ITEM_TYPES>& state) {
+    if (state[item] != 0) {
+        return state[item] == 1;
+    }
+    state[item] = 1;
+    for (const Ingredient& ingredient : draft.recipes[item]) {
+        if (hasCycle(draft, RecipeBook::index(ingredient.item), state)) {
+            return true;
+        }
+    }
+    state[item] = 2;
+    return false;
+}
+
+/**
+ * @brief Vérifie le brouillon et le range dans les tableaux plats
+ */
+bool compile(const Draft& draft, const std::string& source, RecipeBook& book) {
+    book = draft.scalars;
+    std::array<int, NB_ITEM_TYPES> state{};
+    std::size_t nbIngredients = 0;
+
+    /* Un salaire négatif ferait gagner de l'argent à chaque lot */
+    for (std::size_t i = 0; i < NB_EMPLOYEE_TYPES; ++i) {
+        if (book.salaries[i] < 0) {
+            std::cerr << source << ": invalid salary for " << EMPLOYEE_NAMES[i] << std::endl;
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        if (book.costs[i] < 1 || book.batchSizes[i] < 1 || book.buildTimeMinUs[i] > book.buildTimeMaxUs[i]) {
+            std::cerr << source << ": invalid values for " << ITEM_NAMES[i] << std::endl;
+            return false;
+        }
+        if (hasCycle(draft, i, state)) {
+            std::cerr << source << ": the recipe of " << ITEM_NAMES[i] << " depends on itself" << std::endl;
+            return false;
+        }
+
+        book.firstIngredient[i] = std::uint8_t(nbIngredients);
+        for (const Ingredient& ingredient : draft.recipes[i]) {
+            book.ingredients[nbIngredients++] = ingredient;
+        }
+
+        if (draft.recipes[i].empty()) {
+            book.rawMaterials[book.nbRawMaterials++] = static_cast<ItemType>(i);
+        }
+    }
+    for (ItemType item : draft.recipeOrder) {
+        if (!draft.recipes[RecipeBook::index(item)].empty()) {
+            book.products[book.nbProducts++] = item;
+        }
+    }
+    /* ItemType::Nothing : recette vide, prix et salaire nuls */
+    book.firstIngredient[NB_ITEM_TYPES] = std::uint8_t(nbIngredients);
+    book.firstIngredient[NB_ITEM_TYPES + 1] = std::uint8_t(nbIngredients);
+
+    if (book.nbRawMaterials == 0 || book.nbProducts == 0) {
+        std::cerr << source << ": at least one raw material and one product are needed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Draft builtInDraft() {
+    Draft draft;
+    std::istringstream in(BUILT_IN_RECIPES);
+    parse(in, "built-in recipes", draft);
+    return draft;
+}
+
+RecipeBook& activeBook() {
+    static RecipeBook book = [] {
+        RecipeBook compiled;
+        compile(builtInDraft(), "built-in recipes", compiled);
+        return compiled;
+    }();
+    return book;
+}
+
+} // namespace
+
+const RecipeBook& recipeBook() {
+    return activeBook();
+}
+
+bool loadRecipeBook(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open recipe file " << path << std::endl;
+        return false;
+    }
+
+    Draft draft = builtInDraft();
+    RecipeBook book;
+    if (!parse(file, path, draft) || !compile(draft, path, book)) {
+        return false;
+    }
+
+    activeBook() = book;
+    return true;
+}
+
+std::uint64_t drawBuildTimeUs(ItemType item) {
+    const RecipeBook& book = recipeBook();
+    std::size_t i = RecipeBook::index(item);
+    std::uint64_t range = book.buildTimeMaxUs[i] - book.buildTimeMinUs[i];
+    return book.buildTimeMinUs[i] +
+           ThreadRandom::bounded(0, RECIPE_BUILD_TIME_STEPS - 1) * range / (RECIPE_BUILD_TIME_STEPS - 1);
+}
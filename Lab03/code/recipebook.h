@@ -0,0 +1,99 @@
+/**
+ * @file recipebook.h
+ * @brief Tables des prix, salaires et recettes de fabrication, chargées au démarrage.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef RECIPEBOOK_H
+#define RECIPEBOOK_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "itemtype.h"
+
+enum class EmployeeType {Extractor, Electrician, Plasturgist, Engineer};
+
+// Nombre de métiers d'employés
+constexpr std::size_t NB_EMPLOYEE_TYPES = static_cast<std::size_t>(EmployeeType::Engineer) + 1;
+
+// Nombre de durées possibles entre les bornes d'une durée de fabrication
+#define RECIPE_BUILD_TIME_STEPS 100
+
+/**
+ * @brief Ingrédient d'une recette : un type d'objet et la quantité consommée par unité produite
+ */
+struct Ingredient {
+    ItemType item = ItemType::Nothing;
+    int qty = 0;
+};
+
+/**
+ * @brief Catalogue des objets, sous forme de tableaux plats indexés par ItemType.
+ *
+ * ItemType::Nothing a sa propre case, à zéro, si bien qu'une consultation n'a aucun
+ * branchement. Les recettes sont rangées bout à bout dans `ingredients` : celle de
+ * l'objet i occupe [firstIngredient[i], firstIngredient[i + 1]). Une recette peut
+ * demander des objets eux-mêmes fabriqués (nomenclature à plusieurs niveaux) ; un
+ * objet sans recette est une matière première, produite par les mines.
+ */
+struct RecipeBook {
+    static constexpr std::size_t NB_ENTRIES = NB_ITEM_TYPES + 1;
+
+    std::array<int, NB_ENTRIES> costs{};
+    std::array<EmployeeType, NB_ENTRIES> producers{};
+    std::array<int, NB_EMPLOYEE_TYPES> salaries{};
+    // Nombre d'objets produits par cycle de fabrication
+    std::array<int, NB_ENTRIES> batchSizes{};
+    // Bornes de la durée d'un cycle de fabrication ou d'extraction (µs simulées)
+    std::array<std::uint32_t, NB_ENTRIES> buildTimeMinUs{};
+    std::array<std::uint32_t, NB_ENTRIES> buildTimeMaxUs{};
+
+    std::array<Ingredient, NB_ITEM_TYPES * NB_ITEM_TYPES> ingredients{};
+    std::array<std::uint8_t, NB_ENTRIES + 1> firstIngredient{};
+
+    // Objets fabriqués, dans l'ordre des directives `recipe`, et matières premières, dans celui de l'énumération
+    std::array<ItemType, NB_ITEM_TYPES> products{};
+    std::size_t nbProducts = 0;
+    std::array<ItemType, NB_ITEM_TYPES> rawMaterials{};
+    std::size_t nbRawMaterials = 0;
+
+    const Ingredient* recipeBegin(ItemType item) const { return &ingredients[firstIngredient[index(item)]]; }
+    const Ingredient* recipeEnd(ItemType item) const { return &ingredients[firstIngredient[index(item) + 1]]; }
+
+    static std::size_t index(ItemType item) { return static_cast<std::size_t>(item); }
+};
+
+/**
+ * @brief Catalogue en vigueur, celui intégré au programme tant que loadRecipeBook n'a pas réussi
+ */
+const RecipeBook& recipeBook();
+
+/**
+ * @brief Remplace le catalogue en vigueur par celui décrit dans un fichier texte.
+ *
+ * À appeler avant la création des vendeurs : ceux-ci copient leur recette à la construction.
+ * Une directive par ligne, les lignes vides et commençant par `#` sont ignorées :
+ * - `item <objet> <prix> <métier> <lot> <durée min µs> <durée max µs>`
+ * - `salary <métier> <salaire>`
+ * - `recipe <objet> [<ingrédient> <quantité>]...` (sans ingrédient : matière première) ;
+ *   les usines sont réparties entre les objets fabriqués dans l'ordre de ces directives
+ * Les directives absentes gardent les valeurs du catalogue intégré. Le catalogue est refusé
+ * si un prix est inférieur à 1 (les acheteurs divisent leurs fonds par les prix), si un
+ * salaire ou une durée est négatif, ou si une recette dépend, même indirectement, de son
+ * propre produit.
+ *
+ * @param path Le chemin du fichier
+ * @return false si le fichier est illisible ou invalide (message sur std::cerr), le catalogue est alors inchangé
+ */
+bool loadRecipeBook(const std::string& path);
+
+/**
+ * @brief Tire la durée d'un cycle de fabrication de l'objet entre les bornes du catalogue
+ * @param item L'objet fabriqué ou extrait
+ * @return La durée en µs simulées
+ */
+std::uint64_t drawBuildTimeUs(ItemType item);
+
+#endif // RECIPEBOOK_H
@@ -0,0 +1,51 @@
+/**
+ * @file restocknotifier.cpp
+ * @brief Réveils sur évènement des vendeurs en attente de fonds ou de ressources.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "restocknotifier.h"
+
+void Wakeup::signal() {
+    /* Vendeur piloté par l'ordonnanceur à évènements : pas de thread à réveiller.
+     * Un signal déjà en attente a été ou sera vu par l'ordonnanceur. */
+    WakeupListener* target = listener.load();
+    if (target) {
+        if (!pending.exchange(true)) {
+            target->onSignal(this);
+        }
+        return;
+    }
+
+    pending.store(true);
+
+    /* Personne n'attend : celui qui attendra verra `pending` */
+    if (nbWaiting.load() == 0) {
+        return;
+    }
+
+    mutex.lock(); // Début S.C.
+    cond.notifyAll();
+    mutex.unlock(); // Fin S.C.
+}
+
+void Wakeup::wait() {
+    mutex.lock(); // Début S.C.
+    ++nbWaiting;
+    while (!pending.exchange(false)) {
+        cond.wait(&mutex);
+    }
+    --nbWaiting;
+    mutex.unlock(); // Fin S.C.
+}
+
+void RestockNotifier::subscribe(ItemType item, Wakeup* wakeup) {
+    subscribers[static_cast<std::size_t>(item)].push_back(wakeup);
+}
+
+void RestockNotifier::publish(ItemType item) {
+    for (Wakeup* wakeup : subscribers[static_cast<std::size_t>(item)]) {
+        wakeup->signal();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef RESTOCKNOTIFIER_H
+#define RESTOCKNOTIFIER_H
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+#include "itemtype.h"
+
+class Wakeup;
+
+/**
+ * @brief Reçoit les signaux d'un évènement de réveil à la place d'un thread bloqué.
+ *
+ * Utilisé par l'ordonnanceur à évènements discrets : le vendeur n'a pas de thread à
+ * réveiller, c'est sa tâche qui est remise dans l'échéancier.
+ */
+class WakeupListener {
+public:
+    virtual ~WakeupListener() = default;
+
+    /**
+     * @brief Appelé, depuis le thread qui signale, à chaque signal de l'évènement
+     * @param wakeup L'évènement signalé
+     */
+    virtual void onSignal(Wakeup* wakeup) = 0;
+};
+
+/**
+ * @brief Évènement de réveil propre à un vendeur.
+ *
+ * Un vendeur qui ne peut pas progresser (plus d'argent, ressources introuvables) s'y
+ * bloque au lieu de dormir un temps fixe. N'importe quel thread peut le réveiller ;
+ * un signal émis alors que personne n'attend n'est pas perdu, il rend la prochaine
+ * attente immédiate. Lorsqu'aucun thread n'attend, signaler ne prend aucun verrou.
+ */
+class Wakeup {
+public:
+    /**
+     * @brief Réveille le thread en attente, ou le prochain qui attendra
+     */
+    void signal();
+
+    /**
+     * @brief Bloque jusqu'au prochain signal (consommé au réveil)
+     */
+    void wait();
+
+    /**
+     * @brief Consomme le signal en attente sans bloquer
+     * @return true si un signal était en attente
+     */
+    bool tryConsume() { return pending.exchange(false); }
+
+    /**
+     * @brief Redirige les signaux vers un écouteur au lieu de réveiller un thread
+     * @param listener L'écouteur, nullptr pour revenir à l'attente bloquante
+     */
+    void setListener(WakeupListener* listener) { this->listener.store(listener); }
+
+private:
+    std::atomic<bool> pending{false};
+    std::atomic<WakeupListener*> listener{nullptr};
+    std::atomic<int> nbWaiting{0};
+
+    PcoMutex mutex;
+    PcoConditionVariable cond;
+};
+
+/**
+ * @brief Liste d'abonnés au réassort d'un vendeur, par type d'objet.
+ *
+ * Les abonnements se font pendant la mise en place de la simulation, avant le
+ * lancement des threads ; la publication peut ensuite se faire sans verrou.
+ */
+class RestockNotifier {
+public:
+    /**
+     * @brief Abonne un évènement au réassort d'un type d'objet
+     * @param item Le type d'objet surveillé
+     * @param wakeup L'évènement à signaler
+     */
+    void subscribe(ItemType item, Wakeup* wakeup);
+
+    /**
+     * @brief Signale à tous les abonnés que le stock de l'objet a augmenté
+     * @param item Le type d'objet réassorti
+     */
+    void publish(ItemType item);
+
+private:
+    std::array<std::vector<Wakeup*>, NB_ITEM_TYPES> subscribers;
+};
+
+#endif // RESTOCKNOTIFIER_H
@@ -1,36 +1,216 @@
 #include "seller.h"
+#include "marketplace.h"
+#include "pricingengine.h"
+#include "threadrandom.h"
+#include <pcosynchro/pcothread.h>
 #include <algorithm>
-#include <random>
 #include <cassert>
 
+Marketplace* Seller::market = nullptr;
+
+namespace {
+RealTimeClock defaultClock;
+}
+
+SimulationClock* Seller::simClock = &defaultClock;
+
+void Seller::run() {
+    if (!start()) {
+        return;
+    }
+
+    while (!PcoThread::thisThread()->stopRequested()) {
+        Step next = advance();
+        if (next.kind == Step::Kind::Wait) {
+            wakeup.wait();
+        } else if (next.delayUs > 0) {
+            simClock->sleep(next.delayUs);
+        }
+    }
+    finish();
+}
+
+Step Seller::advance() {
+    if (waiting) {
+        /* Le temps propre du vendeur n'a pas avancé pendant l'attente */
+        simClock->catchUp();
+        waiting = false;
+    }
+    if (waitStartUs) {
+        stats.wakeupWait.record(statsNowUs() - waitStartUs);
+        waitStartUs = 0;
+    }
+
+    Step next = step();
+    if (next.kind == Step::Kind::Wait) {
+        waiting = true;
+        waitStartUs = statsNowUs();
+    }
+    return next;
+}
+
 Seller *Seller::chooseRandomSeller(std::vector<Seller *> &sellers) {
     assert(sellers.size());
-    std::vector<Seller*> out;
-    std::sample(sellers.begin(), sellers.end(), std::back_inserter(out),
-            1, std::mt19937{std::random_device{}()});
-    return out.front();
+    return sellers[ThreadRandom::bounded(0, int(sellers.size()) - 1)];
 }
 
-ItemType Seller::chooseRandomItem(std::map<ItemType, int> &itemsForSale) {
-    if (!itemsForSale.size()) {
+ItemType Seller::chooseRandomItem(const ItemsForSale &itemsForSale) {
+    std::array<ItemType, NB_ITEM_TYPES> inStock;
+    std::size_t nbInStock = 0;
+
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        if (itemsForSale[i] > 0) {
+            inStock[nbInStock++] = static_cast<ItemType>(i);
+        }
+    }
+
+    if (!nbInStock) {
         return ItemType::Nothing;
     }
-    std::vector<std::pair<ItemType, int> > out;
-    std::sample(itemsForSale.begin(), itemsForSale.end(), std::back_inserter(out),
-            1, std::mt19937{std::random_device{}()});
-    return out.front().first;
+    return inStock[ThreadRandom::bounded(0, int(nbInStock) - 1)];
+}
+
+bool Seller::tryPay(int amount) {
+    int current = money.load();
+    while (current >= amount) {
+        if (money.compare_exchange_weak(current, current - amount)) {
+            return true;
+        }
+        stats.fundRetries.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+void Seller::deliver(ItemType item, int qty) {
+    onOrder.add(item, -qty);
+    restock(item, qty);
+    wakeup.signal();
+}
+
+void Seller::refund(ItemType item, int qty, int amount) {
+    onOrder.add(item, -qty);
+    credit(amount);
+}
+
+void Seller::setMarketplace(Marketplace* marketplace) {
+    market = marketplace;
+}
+
+void Seller::setClock(SimulationClock* clock) {
+    simClock = clock ? clock : &defaultClock;
+}
+
+int Seller::reserveBatch(Order &order, BatchMode mode, ItemType soldItem) {
+    int bill = 0;
+    bool sellable = false;
+
+    for (std::size_t i = 0; i < order.nbLines; ++i) {
+        OrderLine& line = order.lines[i];
+        line.delivered = 0;
+
+        if (line.qty > 0 && line.item != ItemType::Nothing &&
+            (soldItem == ItemType::Nothing || line.item == soldItem)) {
+            sellable = true;
+            if (mode == BatchMode::AllOrNothing) {
+                line.delivered = stocks.tryRemove(line.item, line.qty) ? line.qty : 0;
+            } else {
+                line.delivered = stocks.tryRemoveUpTo(line.item, line.qty);
+            }
+        }
+
+        if (mode == BatchMode::AllOrNothing && line.delivered == 0) {
+            /* Annulation des lignes déjà réservées */
+            for (std::size_t j = 0; j < i; ++j) {
+                stocks.add(order.lines[j].item, order.lines[j].delivered);
+                order.lines[j].delivered = 0;
+            }
+            stats.countTrade(sellable ? TradeOutcome::OutOfStock : TradeOutcome::WrongItem);
+            return 0;
+        }
+
+        /* Jamais plus que le prix relevé à la commande, pour lequel l'acheteur a vérifié ses fonds */
+        line.unitPrice = getCostPerUnit(line.item);
+        if (line.maxUnitPrice > 0) {
+            line.unitPrice = std::min(line.unitPrice, line.maxUnitPrice);
+        }
+        bill += line.unitPrice * line.delivered;
+    }
+
+    if (bill == 0) {
+        stats.countTrade(sellable ? TradeOutcome::OutOfStock : TradeOutcome::WrongItem);
+        return 0;
+    }
+
+    stats.countTrade(TradeOutcome::Success);
+    creditSale(order, bill);
+    return bill;
+}
+
+void Order::add(ItemType item, int qty) {
+    assert(nbLines < lines.size());
+    lines[nbLines++] = {item, qty, 0, 0, getCostPerUnit(item)};
+}
+
+int Order::cost() const {
+    int total = 0;
+    for (std::size_t i = 0; i < nbLines; ++i) {
+        total += lines[i].maxUnitPrice * lines[i].qty;
+    }
+    return total;
+}
+
+void Order::removeDelivered() {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < nbLines; ++i) {
+        OrderLine line = lines[i];
+        line.qty -= line.delivered;
+        line.delivered = 0;
+        if (line.qty > 0) {
+            lines[kept++] = line;
+        }
+    }
+    nbLines = kept;
+}
+
+bool StockTable::tryRemove(ItemType item, int qty) {
+    std::atomic<int>& counter = counters[index(item)].value;
+    int current = counter.load();
+    while (current >= qty) {
+        if (counter.compare_exchange_weak(current, current - qty)) {
+            return true;
+        }
+        nbRetries.value.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+int StockTable::tryRemoveUpTo(ItemType item, int qty) {
+    std::atomic<int>& counter = counters[index(item)].value;
+    int current = counter.load();
+    while (current > 0) {
+        int taken = std::min(current, qty);
+        if (counter.compare_exchange_weak(current, current - taken)) {
+            return taken;
+        }
+        nbRetries.value.fetch_add(1, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+ItemsForSale StockTable::snapshot() const {
+    ItemsForSale copy;
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        copy[i] = counters[i].value.load();
+    }
+    return copy;
 }
 
 int getCostPerUnit(ItemType item) {
-    switch (item) {
-        case ItemType::Sand : return SAND_COST;
-        case ItemType::Copper : return COPPER_COST;
-        case ItemType::Petrol : return PETROL_COST;
-        case ItemType::Chip : return CHIP_COST;
-        case ItemType::Plastic : return PLASTIC_COST;
-        case ItemType::Robot : return ROBOT_COST;
-        default : return 0;
+    PricingEngine* engine = PricingEngine::getActive();
+    if (engine) {
+        return engine->getPrice(item);
     }
+    return recipeBook().costs[RecipeBook::index(item)];
 }
 
 QString getItemName(ItemType item) {
@@ -47,23 +227,9 @@ QString getItemName(ItemType item) {
 }
 
 EmployeeType getEmployeeThatProduces(ItemType item) {
-    switch (item) {
-        case ItemType::Sand : /* fallthrough */
-        case ItemType::Copper : /* fallthrough */
-        case ItemType::Petrol : return EmployeeType::Extractor;
-        case ItemType::Chip : return EmployeeType::Electrician;
-        case ItemType::Plastic : return EmployeeType::Plasturgist;
-        case ItemType::Robot : return EmployeeType::Engineer;
-        default : return EmployeeType::Extractor; // Why not
-    }
+    return recipeBook().producers[RecipeBook::index(item)];
 }
 
 int getEmployeeSalary(EmployeeType employee) {
-    switch (employee) {
-        case EmployeeType::Extractor : return EXTRACOTR_COST;
-        case EmployeeType::Electrician : return ELECTRICIAN_COST;
-        case EmployeeType::Engineer : return ENGINEER_COST;
-        case EmployeeType::Plasturgist : return PLASTIC_COST;
-        default : return 0;
-    }
+    return recipeBook().salaries[static_cast<std::size_t>(employee)];
 }
@@ -3,17 +3,157 @@
 
 #include <QString>
 #include <QStringBuilder>
-#include <map>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <vector>
-#include "costs.h"
-#include <pcosynchro/pcomutex.h>
+#include "itemtype.h"
+#include "recipebook.h"
+#include "restocknotifier.h"
+#include "seqlock.h"
+#include "sellerstats.h"
+#include "simulationclock.h"
 
-enum class ItemType { Sand, Copper, Petrol, Chip, Plastic, Robot, Nothing};
+class Marketplace;
+
+/**
+ * @brief Table des stocks d'un vendeur.
+ *
+ * Chaque type d'objet possède son propre compteur atomique, placé seul sur sa ligne
+ * de cache. Deux acheteurs de types différents ne se gênent donc pas, et le retrait
+ * d'une quantité se fait par compare-and-swap sans verrou.
+ */
+class StockTable {
+public:
+    /**
+     * @brief Quantité actuellement en stock
+     * @param item Le type d'objet
+     */
+    int get(ItemType item) const {
+        return counters[index(item)].value.load();
+    }
+
+    /**
+     * @brief Ajoute une quantité au stock
+     * @param item Le type d'objet
+     * @param qty La quantité ajoutée
+     */
+    void add(ItemType item, int qty) {
+        counters[index(item)].value.fetch_add(qty);
+    }
+
+    /**
+     * @brief Retire une quantité si, et seulement si, elle est disponible
+     * @param item Le type d'objet
+     * @param qty La quantité à retirer
+     * @return true si la quantité a été réservée, false si le stock est insuffisant
+     */
+    bool tryRemove(ItemType item, int qty);
+
+    /**
+     * @brief Retire au plus la quantité demandée, selon ce qui est disponible
+     * @param item Le type d'objet
+     * @param qty La quantité maximale à retirer
+     * @return La quantité effectivement retirée
+     */
+    int tryRemoveUpTo(ItemType item, int qty);
+
+    /**
+     * @brief Copie instantanée de tous les compteurs
+     */
+    ItemsForSale snapshot() const;
+
+    /**
+     * @brief Nombre d'échecs de compare-and-swap lors des retraits, dus à des accès concurrents
+     */
+    std::uint64_t getNbRetries() const { return nbRetries.value.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Counter {
+        std::atomic<int> value{0};
+    };
+
+    static std::size_t index(ItemType item) { return static_cast<std::size_t>(item); }
+
+    struct alignas(CACHE_LINE_SIZE) RetryCounter {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Counter, NB_ITEM_TYPES> counters;
+    RetryCounter nbRetries;
+};
 
 int getCostPerUnit(ItemType item);
 QString getItemName(ItemType item);
 
-enum class EmployeeType {Extractor, Electrician, Plasturgist, Engineer};
+/**
+ * @brief Ligne d'une commande groupée
+ */
+struct OrderLine {
+    ItemType item = ItemType::Nothing;
+    // Quantité demandée
+    int qty = 0;
+    // Quantité effectivement livrée, renseignée par Seller::tradeBatch
+    int delivered = 0;
+    // Prix unitaire facturé pour la quantité livrée, renseigné par Seller::tradeBatch
+    int unitPrice = 0;
+    // Prix unitaire au plus accepté par l'acheteur, relevé par Order::add ; 0 : aucune limite
+    int maxUnitPrice = 0;
+};
+
+/**
+ * @brief Commande groupée de plusieurs types d'objets, au plus une ligne par type.
+ *
+ * Les lignes sont stockées dans un tableau de taille fixe : passer une commande
+ * n'alloue rien.
+ */
+struct Order {
+    std::array<OrderLine, NB_ITEM_TYPES> lines;
+    std::size_t nbLines = 0;
+
+    /**
+     * @brief Ajoute une ligne à la commande, au prix courant : le vendeur ne pourra facturer plus
+     */
+    void add(ItemType item, int qty);
+
+    bool empty() const { return nbLines == 0; }
+
+    /**
+     * @brief Coût total des quantités demandées aux prix relevés par add, soit le plus
+     *        que la commande puisse coûter
+     */
+    int cost() const;
+
+    /**
+     * @brief Retire les quantités livrées, ne garde que ce qu'il reste à obtenir
+     */
+    void removeDelivered();
+};
+
+/**
+ * @brief Manière de traiter une commande groupée qui ne peut être entièrement servie
+ */
+enum class BatchMode {
+    AllOrNothing, // Rien n'est vendu si une seule ligne ne peut être servie
+    BestEffort    // Chaque ligne est servie au mieux du stock disponible
+};
+
+/**
+ * @brief Suite demandée par un vendeur à la fin d'une étape de sa routine
+ */
+struct Step {
+    enum class Kind {
+        Sleep, // Reprendre après `delayUs` microsecondes simulées (0 : immédiatement)
+        Wait   // Reprendre au prochain signal de l'évènement de réveil du vendeur
+    };
+
+    Kind kind;
+    std::uint64_t delayUs;
+
+    static Step sleep(std::uint64_t delayUs) { return {Kind::Sleep, delayUs}; }
+    static Step next() { return sleep(0); }
+    static Step wait() { return {Kind::Wait, 0}; }
+};
 
 EmployeeType getEmployeeThatProduces(ItemType item);
 int getEmployeeSalary(EmployeeType employee);
@@ -26,11 +166,13 @@ public:
      */
     Seller(int money, int uniqueId) : money(money), uniqueId(uniqueId) {}
 
+    virtual ~Seller() = default;
+
     /**
      * @brief getItemsForSale
-     * @return The list of items for sale
+     * @return The quantity for sale of each item type
      */
-    virtual std::map<ItemType, int> getItemsForSale() = 0;
+    virtual ItemsForSale getItemsForSale() = 0;
 
     /**
      * @brief Fonction permettant d'acheter des ressources au vendeur
@@ -40,6 +182,46 @@ public:
      */
     virtual int trade(ItemType what, int qty) = 0;
 
+    /**
+     * @brief Achète plusieurs ressources au vendeur en une seule transaction
+     * @param order La commande ; le champ `delivered` de chaque ligne est mis à jour
+     * @param mode Tout ou rien, ou au mieux du stock disponible
+     * @return La facture totale de ce qui a été livré, 0 si rien ne l'a été
+     */
+    virtual int tradeBatch(Order& order, BatchMode mode) = 0;
+
+    /**
+     * @brief Routine du vendeur lorsqu'il a son propre thread.
+     *
+     * Enchaîne les étapes jusqu'à la demande d'arrêt : les pauses passent par l'horloge
+     * de simulation, les attentes bloquent le thread sur l'évènement de réveil.
+     */
+    void run();
+
+    /**
+     * @brief Exécute une étape (step) en comptant le temps passé à attendre depuis la précédente.
+     *        C'est par elle que les exécuteurs (thread, ordonnanceur, pool) font avancer le vendeur.
+     * @return Quand reprendre : après une pause ou au prochain réveil
+     */
+    Step advance();
+
+    /**
+     * @brief Prépare la routine (message de démarrage, flux aléatoire)
+     * @return false si le vendeur n'est pas en état de démarrer
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief Exécute une étape de la routine sans jamais bloquer
+     * @return Quand reprendre : après une pause ou au prochain réveil
+     */
+    virtual Step step() = 0;
+
+    /**
+     * @brief Termine le travail commencé et clôt la routine
+     */
+    virtual void finish() = 0;
+
     /**
      * @brief chooseRandomSeller
      * @param sellers
@@ -48,25 +230,172 @@ public:
     static Seller* chooseRandomSeller(std::vector<Seller*>& sellers);
 
     /**
-     * @brief Chooses a random item type from an items for sale map
+     * @brief Chooses a random item type among the ones actually in stock
      * @param itemsForSale
-     * @return Returns the item type
+     * @return Returns the item type, ItemType::Nothing if nothing is in stock
      */
-    static ItemType chooseRandomItem(std::map<ItemType, int>& itemsForSale);
+    static ItemType chooseRandomItem(const ItemsForSale& itemsForSale);
 
-    int getFund() { return money; }
+    /**
+     * @brief Fonds du vendeur, recettes pas encore encaissées comprises
+     */
+    virtual int getFund() { return money.load(); }
 
     int getUniqueId() { return uniqueId; }
 
+    /**
+     * @brief Quantité en stock d'un type d'objet, qu'il soit à vendre ou non
+     */
+    int getStock(ItemType item) const { return stocks.get(item); }
+
+    /**
+     * @brief Applique aux fonds et aux stocks l'effet d'un évènement rejoué (voir replayEventLog).
+     *        Réservé au rejeu : ni l'interface ni les abonnés au réassort ne sont prévenus.
+     * @param fundDelta Variation des fonds
+     * @param item Le type d'objet concerné, ItemType::Nothing si seuls les fonds changent
+     * @param qtyDelta Variation du stock
+     */
+    void applyReplayed(int fundDelta, ItemType item, int qtyDelta) {
+        money += fundDelta;
+        if (item != ItemType::Nothing) {
+            stocks.add(item, qtyDelta);
+        }
+    }
+
+    /**
+     * @brief Dernier instantané publié des stocks, lisible sans verrou depuis n'importe quel thread
+     */
+    const SeqLock<ItemsForSale>& getStockSnapshot() const { return stockSnapshot; }
+
+    /**
+     * @brief Réveille le vendeur s'il attend des fonds ou des ressources
+     */
+    void wakeUp() { wakeup.signal(); }
+
+    Wakeup& getWakeup() { return wakeup; }
+
+    const SellerStats& getStats() const { return stats; }
+
+    std::uint64_t getNbStockRetries() const { return stocks.getNbRetries(); }
+
+    /**
+     * @brief Demande à être réveillé chaque fois que ce vendeur réassortit un objet
+     * @param item Le type d'objet surveillé
+     * @param subscriber L'évènement à signaler
+     */
+    virtual void subscribeRestock(ItemType item, Wakeup* subscriber) { restocks.subscribe(item, subscriber); }
+
+    /**
+     * @brief Livraison d'objets achetés sur la place de marché (déjà payés)
+     * @param item Le type d'objet livré
+     * @param qty La quantité livrée
+     */
+    virtual void deliver(ItemType item, int qty);
+
+    /**
+     * @brief Remboursement d'une offre d'achat de la place de marché restée sans suite
+     * @param item Le type d'objet qui était commandé
+     * @param qty La quantité qui était commandée
+     * @param amount Le montant rendu
+     */
+    void refund(ItemType item, int qty, int amount);
+
+    /**
+     * @brief Active le mode place de marché pour tous les vendeurs
+     * @param marketplace La place de marché, nullptr pour les échanges directs
+     */
+    static void setMarketplace(Marketplace* marketplace);
+
+    /**
+     * @brief Choisit l'horloge qui rythme tous les vendeurs
+     * @param clock L'horloge, nullptr pour revenir au temps réel
+     */
+    static void setClock(SimulationClock* clock);
+
 protected:
     /**
-     * @brief stocks : Type, Quantité
+     * @brief Encaisse le produit d'une vente et réveille le vendeur s'il attendait des fonds
+     * @param amount Le montant encaissé
      */
-    std::map<ItemType, int> stocks;
-    int money;
+    void credit(int amount) {
+        money += amount;
+        wakeup.signal();
+    }
+
+    /**
+     * @brief Publie un nouvel instantané des stocks (nouvelle époque)
+     * @return L'instantané, à transmettre à l'interface
+     */
+    const SeqLock<ItemsForSale>* publishStocks() {
+        stockSnapshot.write(stocks.snapshot());
+        return &stockSnapshot;
+    }
+
+    /**
+     * @brief Ajoute des objets au stock et prévient les abonnés au réassort
+     * @param item Le type d'objet
+     * @param qty La quantité ajoutée
+     */
+    void restock(ItemType item, int qty) {
+        stocks.add(item, qty);
+        restocks.publish(item);
+    }
+
+    /**
+     * @brief Débite les fonds de manière atomique s'ils sont suffisants
+     * @param amount Le montant à payer
+     * @return true si le paiement a été effectué, false si les fonds sont insuffisants
+     */
+    bool tryPay(int amount);
+
+    /**
+     * @brief Réserve les lignes d'une commande groupée et encaisse la facture
+     * @param order La commande à servir
+     * @param mode Tout ou rien, ou au mieux
+     * @param soldItem Seul type vendu par ce vendeur, ItemType::Nothing s'il les vend tous
+     * @return La facture totale, 0 si rien n'a été livré
+     */
+    int reserveBatch(Order& order, BatchMode mode, ItemType soldItem);
+
+    /**
+     * @brief Encaisse la facture d'une commande groupée servie par reserveBatch
+     * @param order La commande, avec les quantités livrées
+     * @param bill Le montant total
+     */
+    virtual void creditSale(const Order& order, int bill) {
+        (void) order;
+        credit(bill);
+    }
+
+    /**
+     * @brief stocks : Quantité par type
+     */
+    StockTable stocks;
+    // Copie versionnée des stocks destinée aux lecteurs externes (interface graphique)
+    SeqLock<ItemsForSale> stockSnapshot;
+    std::atomic<int> money;
     int uniqueId;
 
-    PcoMutex resourcesProtector; // TODO : (ACH) A voir + renommer ?
+    // Évènement sur lequel le vendeur se bloque lorsqu'il ne peut pas progresser
+    Wakeup wakeup;
+    // Abonnés au réassort de ce vendeur
+    RestockNotifier restocks;
+
+    // Quantités commandées sur la place de marché et pas encore livrées
+    StockTable onOrder;
+
+    // Issues des ventes, conflits sur les fonds et temps d'attente
+    SellerStats stats;
+    // Début de l'attente en cours (µs de temps réel), 0 si le vendeur n'attend pas
+    std::uint64_t waitStartUs = 0;
+    // La dernière étape a demandé d'attendre un réveil
+    bool waiting = false;
+
+    // Place de marché commune, nullptr si les vendeurs échangent directement
+    static Marketplace* market;
+
+    // Horloge commune qui rythme les pauses des vendeurs
+    static SimulationClock* simClock;
 };
 
 #endif // SELLER_H
@@ -0,0 +1,52 @@
+/**
+ * @file sellerarena.cpp
+ * @brief Blocs de l'arène des vendeurs.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "sellerarena.h"
+#include "seller.h"
+#include <cstdint>
+
+SellerArena::SellerArena(std::size_t chunkBytes) : chunkBytes(chunkBytes) {}
+
+SellerArena::~SellerArena() {
+    /* Les derniers créés peuvent dépendre des premiers : destruction dans l'ordre inverse */
+    for (auto it = sellers.rbegin(); it != sellers.rend(); ++it) {
+        (*it)->~Seller();
+    }
+    for (const Chunk& chunk : chunks) {
+        ::operator delete(chunk.data, chunk.size, std::align_val_t(CACHE_LINE_SIZE));
+    }
+}
+
+void SellerArena::destroy(Seller* seller) {
+    auto it = std::find(sellers.begin(), sellers.end(), seller);
+    if (it == sellers.end()) {
+        return;
+    }
+    sellers.erase(it);
+    seller->~Seller();
+}
+
+void* SellerArena::allocate(std::size_t size, std::size_t alignment) {
+    if (!chunks.empty()) {
+        const Chunk& chunk = chunks.back();
+        auto address = reinterpret_cast<std::uintptr_t>(chunk.data) + offset;
+        std::size_t padding = (alignment - address % alignment) % alignment;
+        if (offset + padding + size <= chunk.size) {
+            offset += padding + size;
+            bytesUsed += padding + size;
+            return chunk.data + offset - size;
+        }
+    }
+
+    /* Bloc plein : le suivant est aligné sur une ligne de cache, avec de la marge pour un alignement plus fort */
+    std::size_t needed = size + (alignment > CACHE_LINE_SIZE ? alignment : 0);
+    std::size_t bytes = std::max(chunkBytes, needed);
+    auto data = static_cast<std::byte*>(::operator new(bytes, std::align_val_t(CACHE_LINE_SIZE)));
+    chunks.push_back({data, bytes});
+    offset = 0;
+    return allocate(size, alignment);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file sellerarena.h
+ * @brief Arène qui loge les vendeurs d'une simulation côte à côte, sans allocation individuelle.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef SELLERARENA_H
+#define SELLERARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "itemtype.h"
+
+class Seller;
+
+// Taille d'un bloc de l'arène ; un vendeur plus grand reçoit un bloc à sa mesure
+#define SELLER_ARENA_CHUNK_BYTES (64 * 1024)
+
+/**
+ * @brief Arène de vendeurs.
+ *
+ * Les vendeurs sont construits en place, les uns à la suite des autres, dans de grands
+ * blocs alloués d'un coup : une simulation de milliers de vendeurs ne fait que quelques
+ * allocations, et les vendeurs créés ensemble (toutes les mines, puis tous les grossistes...)
+ * ont leurs fonds et leurs stocks dans une même zone mémoire. Chaque vendeur commence sur
+ * une nouvelle ligne de cache : deux vendeurs voisins ne se disputent jamais une ligne.
+ *
+ * La mémoire n'est rendue qu'à la destruction de l'arène, qui détruit aussi les vendeurs
+ * restants. Créer un vendeur n'est pas thread-safe : l'arène est remplie à la mise en place.
+ */
+class SellerArena
+{
+public:
+    /**
+     * @param chunkBytes Taille des blocs alloués
+     */
+    explicit SellerArena(std::size_t chunkBytes = SELLER_ARENA_CHUNK_BYTES);
+
+    ~SellerArena();
+
+    SellerArena(const SellerArena&) = delete;
+    SellerArena& operator=(const SellerArena&) = delete;
+
+    /**
+     * @brief Construit un vendeur dans l'arène
+     * @param args Les paramètres du constructeur de T
+     * @return Le vendeur, détenu par l'arène : ne pas le libérer avec delete
+     */
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_base_of<Seller, T>::value, "L'arène ne loge que des vendeurs");
+        void* place = allocate(sizeof(T), std::max(alignof(T), CACHE_LINE_SIZE));
+        T* seller = new (place) T(std::forward<Args>(args)...);
+        sellers.push_back(seller);
+        return seller;
+    }
+
+    /**
+     * @brief Détruit un vendeur de l'arène ; sa place n'est pas réutilisée
+     */
+    void destroy(Seller* seller);
+
+    std::size_t getNbSellers() const { return sellers.size(); }
+    std::size_t getNbChunks() const { return chunks.size(); }
+
+    /**
+     * @brief Octets occupés par les vendeurs, alignement compris
+     */
+    std::size_t getBytesUsed() const { return bytesUsed; }
+
+private:
+    struct Chunk {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    /**
+     * @brief Réserve `size` octets alignés sur `alignment` dans le bloc courant, ou dans un nouveau bloc
+     */
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    const std::size_t chunkBytes;
+    std::vector<Chunk> chunks;
+    // Octets déjà réservés dans le dernier bloc
+    std::size_t offset = 0;
+    std::size_t bytesUsed = 0;
+    // Vendeurs vivants, dans l'ordre de création
+    std::vector<Seller*> sellers;
+};
+
+#endif // SELLERARENA_H
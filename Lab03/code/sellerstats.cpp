@@ -0,0 +1,45 @@
+/**
+ * @file sellerstats.cpp
+ * @brief Histogrammes de durées pour les statistiques des vendeurs et de la place de marché.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "sellerstats.h"
+#include <algorithm>
+
+void LatencyHistogram::record(std::uint64_t us) {
+    std::size_t bucket = 0;
+    while (bucket + 1 < NB_BUCKETS && (us >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalUs.fetch_add(us, std::memory_order_relaxed);
+
+    std::uint64_t current = maxUs.load(std::memory_order_relaxed);
+    while (current < us && !maxUs.compare_exchange_weak(current, us, std::memory_order_relaxed)) {}
+}
+
+double LatencyHistogram::getMeanUs() const {
+    std::uint64_t n = getCount();
+    return n ? double(totalUs.load(std::memory_order_relaxed)) / n : 0.0;
+}
+
+std::uint64_t LatencyHistogram::getPercentileUs(double fraction) const {
+    std::uint64_t n = getCount();
+    if (n == 0) {
+        return 0;
+    }
+
+    std::uint64_t rank = std::uint64_t(fraction * n);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < NB_BUCKETS; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > rank) {
+            return std::min((std::uint64_t(1) << (i + 1)) - 1, getMaxUs());
+        }
+    }
+    return getMaxUs();
+}
@@ -0,0 +1,90 @@
+#ifndef SELLERSTATS_H
+#define SELLERSTATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Histogramme de durées à classes logarithmiques, alimenté sans verrou.
+ *
+ * La classe i compte les durées de [2^i, 2^(i+1)[ microsecondes (la classe 0 inclut
+ * les durées nulles). Les centiles rendus sont la borne haute de leur classe, au plus
+ * la durée maximale observée.
+ */
+class LatencyHistogram {
+public:
+    static constexpr std::size_t NB_BUCKETS = 32;
+
+    /**
+     * @brief Compte une durée
+     * @param us La durée en microsecondes
+     */
+    void record(std::uint64_t us);
+
+    std::uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Durée moyenne en microsecondes, 0 si rien n'a été compté
+     */
+    double getMeanUs() const;
+
+    std::uint64_t getMaxUs() const { return maxUs.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Centile approché
+     * @param fraction Le centile voulu, entre 0 et 1 (0.99 pour le 99e)
+     * @return Borne haute de la classe qui le contient, en microsecondes
+     */
+    std::uint64_t getPercentileUs(double fraction) const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, NB_BUCKETS> buckets{};
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> totalUs{0};
+    std::atomic<std::uint64_t> maxUs{0};
+};
+
+/**
+ * @brief Issue d'une demande de vente (trade ou tradeBatch) reçue par un vendeur
+ */
+enum class TradeOutcome {
+    Success,
+    OutOfStock,      // Stock insuffisant au moment de la réservation
+    WrongItem,       // Objet que le vendeur ne vend pas
+    InvalidQuantity, // Quantité nulle ou négative
+    NbOutcomes
+};
+
+/**
+ * @brief Statistiques propres à un vendeur.
+ *
+ * Les compteurs sont incrémentés par les threads des acheteurs aussi bien que par
+ * celui du vendeur ; l'ordre relâché suffit, ils ne sont lus qu'au bilan.
+ */
+struct SellerStats {
+    std::array<std::atomic<std::uint64_t>, std::size_t(TradeOutcome::NbOutcomes)> trades{};
+    // Échecs de compare-and-swap sur les fonds (tryPay), dus à un accès concurrent
+    std::atomic<std::uint64_t> fundRetries{0};
+    // Durées passées à attendre un réveil (fonds, réassort ou livraison)
+    LatencyHistogram wakeupWait;
+
+    void countTrade(TradeOutcome outcome) {
+        trades[std::size_t(outcome)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getNbTrades(TradeOutcome outcome) const {
+        return trades[std::size_t(outcome)].load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Instant courant en microsecondes de temps réel, pour mesurer des durées
+ */
+inline std::uint64_t statsNowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // SELLERSTATS_H
@@ -0,0 +1,89 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Valeur publiée sous verrou séquentiel (seqlock).
+ *
+ * Les écrivains s'excluent brièvement entre eux le temps de recopier la valeur ;
+ * les lecteurs ne prennent jamais de verrou et ne bloquent jamais un écrivain :
+ * ils recommencent leur copie si une écriture a eu lieu pendant celle-ci. La
+ * valeur lue est donc toujours une valeur publiée complète, jamais un mélange.
+ *
+ * Chaque écriture incrémente l'époque, ce qui permet à un lecteur de savoir si
+ * la valeur a changé depuis sa dernière lecture.
+ */
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock ne publie que des types trivialement copiables");
+
+public:
+    /**
+     * @brief Publie une nouvelle valeur
+     */
+    void write(const T& value) {
+        std::uint64_t buffer[NB_WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        std::uint64_t seq = sequence.load(std::memory_order_relaxed);
+        do {
+            while (seq & 1) {
+                seq = sequence.load(std::memory_order_relaxed);
+            }
+        } while (!sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+                                                 std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < NB_WORDS; ++i) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Lit la dernière valeur publiée
+     * @param epoch Si non nul, reçoit l'époque de la valeur lue
+     */
+    T read(std::uint64_t* epoch = nullptr) const {
+        std::uint64_t buffer[NB_WORDS];
+        std::uint64_t before;
+        std::uint64_t after;
+
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < NB_WORDS; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        if (epoch) {
+            *epoch = before / 2;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Nombre de valeurs publiées jusqu'ici
+     */
+    std::uint64_t getEpoch() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t NB_WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence{0};
+    std::array<std::atomic<std::uint64_t>, NB_WORDS> words{};
+};
+
+#endif // SEQLOCK_H
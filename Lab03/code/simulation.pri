@@ -0,0 +1,61 @@
+# Sources communes à la version graphique et à la version sans affichage
+# de la simulation. Ce fichier est inclus par Lab3_Factory.pro et
+# Lab3_Factory_headless.pro.
+
+# Les routines en coroutines (CoroutineScheduler) demandent C++20
+CONFIG += c++2a
+
+LIBS += -lpcosynchro
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/coroutinescheduler.cpp \
+    $$PWD/discreteeventengine.cpp \
+    $$PWD/eventlog.cpp \
+    $$PWD/extractor.cpp \
+    $$PWD/factory.cpp \
+    $$PWD/fundsauditor.cpp \
+    $$PWD/marketplace.cpp \
+    $$PWD/moneyledger.cpp \
+    $$PWD/partition.cpp \
+    $$PWD/pricingengine.cpp \
+    $$PWD/recipebook.cpp \
+    $$PWD/restocknotifier.cpp \
+    $$PWD/seller.cpp \
+    $$PWD/sellerarena.cpp \
+    $$PWD/sellerstats.cpp \
+    $$PWD/simulationclock.cpp \
+    $$PWD/threadrandom.cpp \
+    $$PWD/topology.cpp \
+    $$PWD/transactionlog.cpp \
+    $$PWD/utils.cpp \
+    $$PWD/wholesale.cpp \
+    $$PWD/workstealingpool.cpp
+
+HEADERS += \
+    $$PWD/coroutinescheduler.h \
+    $$PWD/discreteeventengine.h \
+    $$PWD/eventlog.h \
+    $$PWD/extractor.h \
+    $$PWD/factory.h \
+    $$PWD/fundsauditor.h \
+    $$PWD/itemtype.h \
+    $$PWD/marketplace.h \
+    $$PWD/moneyledger.h \
+    $$PWD/partition.h \
+    $$PWD/pricingengine.h \
+    $$PWD/recipebook.h \
+    $$PWD/restocknotifier.h \
+    $$PWD/seller.h \
+    $$PWD/sellerarena.h \
+    $$PWD/sellerstats.h \
+    $$PWD/seqlock.h \
+    $$PWD/simulationclock.h \
+    $$PWD/simulationinterface.h \
+    $$PWD/threadrandom.h \
+    $$PWD/topology.h \
+    $$PWD/transactionlog.h \
+    $$PWD/utils.h \
+    $$PWD/wholesale.h \
+    $$PWD/workstealingpool.h
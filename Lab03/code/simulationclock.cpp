@@ -0,0 +1,85 @@
+/**
+ * @file simulationclock.cpp
+ * @brief Horloges de la simulation : temps réel, accéléré et aussi vite que possible.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "simulationclock.h"
+#include <algorithm>
+#include <cassert>
+#include <thread>
+#include <pcosynchro/pcothread.h>
+
+RealTimeClock::RealTimeClock() : start(std::chrono::steady_clock::now()) {}
+
+void RealTimeClock::sleep(std::uint64_t simulatedUs) {
+    PcoThread::usleep(simulatedUs);
+}
+
+std::uint64_t RealTimeClock::elapse(std::uint64_t simulatedUs) {
+    return simulatedUs;
+}
+
+std::uint64_t RealTimeClock::now() {
+    return realElapsedUs();
+}
+
+std::uint64_t RealTimeClock::realElapsedUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+ScaledClock::ScaledClock(double factor) : factor(factor) {
+    assert(factor > 0.0);
+}
+
+void ScaledClock::sleep(std::uint64_t simulatedUs) {
+    PcoThread::usleep(static_cast<std::uint64_t>(simulatedUs / factor));
+}
+
+std::uint64_t ScaledClock::elapse(std::uint64_t simulatedUs) {
+    return static_cast<std::uint64_t>(simulatedUs / factor);
+}
+
+std::uint64_t ScaledClock::now() {
+    return static_cast<std::uint64_t>(realElapsedUs() * factor);
+}
+
+namespace {
+// Temps simulé propre à chaque thread pour FastClock
+thread_local std::uint64_t threadTime = 0;
+// Temps avancé par les pauses du thread : le sien, ou celui de la tâche qu'il exécute
+thread_local std::uint64_t* timeline = nullptr;
+}
+
+void FastClock::sleep(std::uint64_t simulatedUs) {
+    elapse(simulatedUs);
+    std::this_thread::yield();
+}
+
+std::uint64_t FastClock::elapse(std::uint64_t simulatedUs) {
+    std::uint64_t& time = timeline ? *timeline : threadTime;
+    time += simulatedUs;
+
+    std::uint64_t current = latest.load();
+    while (current < time && !latest.compare_exchange_weak(current, time)) {}
+
+    return 0;
+}
+
+void FastClock::setThreadTimeline(std::uint64_t* time) {
+    timeline = time;
+}
+
+std::uint64_t FastClock::now() {
+    return latest.load();
+}
+
+std::uint64_t FastClock::localNow() {
+    return timeline ? *timeline : threadTime;
+}
+
+void FastClock::catchUp() {
+    std::uint64_t& time = timeline ? *timeline : threadTime;
+    time = std::max(time, latest.load());
+}
@@ -0,0 +1,114 @@
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Horloge de la simulation, injectée dans les vendeurs.
+ *
+ * Toutes les durées de la simulation (minage, assemblage, pauses des grossistes)
+ * sont exprimées en microsecondes simulées ; l'horloge décide combien de temps
+ * réel elles coûtent.
+ */
+class SimulationClock {
+public:
+    virtual ~SimulationClock() = default;
+
+    /**
+     * @brief Fait patienter le thread appelant pendant une durée simulée
+     * @param simulatedUs Durée simulée en microsecondes
+     */
+    virtual void sleep(std::uint64_t simulatedUs) = 0;
+
+    /**
+     * @brief Comptabilise une pause sans bloquer, pour les exécuteurs qui programment la reprise eux-mêmes
+     * @param simulatedUs Durée simulée en microsecondes
+     * @return Durée réelle de la pause en microsecondes
+     */
+    virtual std::uint64_t elapse(std::uint64_t simulatedUs) = 0;
+
+    /**
+     * @brief Temps simulé écoulé depuis la création de l'horloge, en microsecondes
+     */
+    virtual std::uint64_t now() = 0;
+
+    /**
+     * @brief Temps simulé propre au thread ou à la tâche appelante, en microsecondes.
+     *        Identique à now() sauf pour les horloges où chacun avance à son rythme.
+     */
+    virtual std::uint64_t localNow() { return now(); }
+
+    /**
+     * @brief Remet le thread ou la tâche appelante à l'heure de la simulation, après une
+     *        attente d'évènement pendant laquelle son propre temps n'a pas avancé
+     */
+    virtual void catchUp() {}
+};
+
+/**
+ * @brief Temps réel : une microseconde simulée dure une microseconde
+ */
+class RealTimeClock : public SimulationClock {
+public:
+    RealTimeClock();
+
+    void sleep(std::uint64_t simulatedUs) override;
+    std::uint64_t elapse(std::uint64_t simulatedUs) override;
+    std::uint64_t now() override;
+
+protected:
+    std::uint64_t realElapsedUs() const;
+
+private:
+    const std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Temps accéléré (ou ralenti) d'un facteur constant
+ */
+class ScaledClock : public RealTimeClock {
+public:
+    /**
+     * @param factor Nombre de secondes simulées par seconde réelle (> 0)
+     */
+    explicit ScaledClock(double factor);
+
+    void sleep(std::uint64_t simulatedUs) override;
+    std::uint64_t elapse(std::uint64_t simulatedUs) override;
+    std::uint64_t now() override;
+
+private:
+    const double factor;
+};
+
+/**
+ * @brief Aussi vite que possible : dormir ne coûte aucun temps réel.
+ *
+ * Chaque thread avance son propre temps simulé de la durée de ses pauses ; le temps
+ * de la simulation est le plus avancé d'entre eux. Le thread cède simplement le
+ * processeur pour laisser les autres vendeurs progresser. Un vendeur réveillé après
+ * une attente reprend au temps de la simulation (catchUp), et non à celui où il s'est
+ * mis en attente.
+ */
+class FastClock : public SimulationClock {
+public:
+    void sleep(std::uint64_t simulatedUs) override;
+    std::uint64_t elapse(std::uint64_t simulatedUs) override;
+    std::uint64_t now() override;
+    std::uint64_t localNow() override;
+    void catchUp() override;
+
+    /**
+     * @brief Choisit le temps simulé qu'avancent les pauses du thread appelant.
+     *        Un exécuteur de tâches y associe le temps propre de la tâche en cours.
+     * @param timeline Le temps à avancer, nullptr pour le temps propre du thread
+     */
+    static void setThreadTimeline(std::uint64_t* timeline);
+
+private:
+    std::atomic<std::uint64_t> latest{0};
+};
+
+#endif // SIMULATIONCLOCK_H
@@ -0,0 +1,38 @@
+#ifndef SIMULATIONINTERFACE_H
+#define SIMULATIONINTERFACE_H
+
+#include <QString>
+#include "seller.h"
+#include "transactionlog.h"
+
+/**
+ * @brief Interface abstraite au travers de laquelle les vendeurs publient leur état.
+ *
+ * Les mines, usines et grossistes ne connaissent que cette interface. L'implémentation
+ * graphique (WindowInterface) relaie les appels vers la fenêtre Qt, tandis que
+ * l'implémentation sans affichage (HeadlessInterface) se contente de les compter.
+ * Le choix se fait au démarrage via les `setInterface` statiques des vendeurs.
+ *
+ * Les messages répétés à chaque échange passent par `logTransaction`, sous forme de
+ * LogRecord : une implémentation peut ainsi n'en faire le texte que s'il est affiché.
+ */
+class SimulationInterface
+{
+public:
+    virtual ~SimulationInterface() = default;
+
+    virtual void consoleAppendText(unsigned int consoleId, QString text) = 0;
+
+    /**
+     * @brief Message de console d'un échange, mis en texte et affiché aussitôt par défaut
+     */
+    virtual void logTransaction(const LogRecord& record) {
+        consoleAppendText(record.consoleId, formatLogRecord(record));
+    }
+
+    virtual void updateFund(unsigned int id, unsigned new_fund) = 0;
+    virtual void updateStock(unsigned int id, const SeqLock<ItemsForSale>* stocks) = 0;
+    virtual void setLink(int from, int to) = 0;
+};
+
+#endif // SIMULATIONINTERFACE_H
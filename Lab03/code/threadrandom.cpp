@@ -0,0 +1,67 @@
+/**
+ * @file threadrandom.cpp
+ * @brief Générateurs pseudo-aléatoires par thread, dérivés d'une graine globale.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "threadrandom.h"
+#include <atomic>
+#include <random>
+
+namespace {
+
+std::atomic<std::uint64_t> globalSeed{0};
+// Les threads non rattachés à un vendeur reçoivent des flux numérotés à partir d'ici
+std::atomic<std::uint64_t> nextAnonymousStream{1ULL << 32};
+
+std::uint64_t splitmix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t streamSeed(std::uint64_t streamId) {
+    std::uint64_t x = globalSeed.load() ^ (streamId * 0xd1b54a32d192ed03ULL);
+    return splitmix64(x);
+}
+
+struct ThreadState {
+    ThreadState() : engine(streamSeed(nextAnonymousStream++)) {}
+    Xoshiro256 engine;
+};
+
+thread_local ThreadState threadState;
+
+} // namespace
+
+void Xoshiro256::reseed(std::uint64_t seed) {
+    for (auto& word : state) {
+        word = splitmix64(seed);
+    }
+}
+
+void ThreadRandom::seed(std::uint64_t seed) {
+    if (seed == 0) {
+        seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+    }
+    globalSeed = seed;
+}
+
+std::uint64_t ThreadRandom::getSeed() {
+    return globalSeed.load();
+}
+
+void ThreadRandom::bindStream(std::uint64_t streamId) {
+    threadState.engine.reseed(streamSeed(streamId));
+}
+
+Xoshiro256& ThreadRandom::engine() {
+    return threadState.engine;
+}
+
+int ThreadRandom::bounded(int lowest, int highest) {
+    std::uniform_int_distribution<int> distribution(lowest, highest);
+    return distribution(threadState.engine);
+}
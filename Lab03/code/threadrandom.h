@@ -0,0 +1,88 @@
+#ifndef THREADRANDOM_H
+#define THREADRANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Générateur pseudo-aléatoire xoshiro256** (32 octets d'état).
+ *
+ * Satisfait UniformRandomBitGenerator, il peut donc être passé aux distributions
+ * et algorithmes de <random> et <algorithm>.
+ */
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed = 0) { reseed(seed); }
+
+    /**
+     * @brief Réinitialise l'état à partir d'une graine (étendue par splitmix64)
+     */
+    void reseed(std::uint64_t seed);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    std::uint64_t state[4];
+};
+
+/**
+ * @brief Service de nombres aléatoires par thread.
+ *
+ * Chaque thread possède son propre générateur, sans verrou ni appel système après sa
+ * création, contrairement à `rand()` (état global non thread-safe) ou à un
+ * `std::mt19937{std::random_device{}()}` construit à chaque tirage.
+ *
+ * Tous les flux dérivent d'une graine globale : un vendeur qui appelle `bindStream`
+ * avec son identifiant au début de sa routine tire toujours la même suite pour une
+ * graine donnée, ce qui rend les exécutions reproductibles.
+ */
+class ThreadRandom {
+public:
+    /**
+     * @brief Fixe la graine globale. À appeler avant le lancement des threads.
+     * @param seed La graine, 0 pour en tirer une au hasard
+     */
+    static void seed(std::uint64_t seed);
+
+    /**
+     * @brief Graine globale utilisée pour cette exécution
+     */
+    static std::uint64_t getSeed();
+
+    /**
+     * @brief Rattache le thread courant au flux d'un identifiant (typiquement celui du vendeur)
+     * @param streamId L'identifiant du flux
+     */
+    static void bindStream(std::uint64_t streamId);
+
+    /**
+     * @brief Générateur du thread courant
+     */
+    static Xoshiro256& engine();
+
+    /**
+     * @brief Entier uniforme dans [lowest, highest]
+     */
+    static int bounded(int lowest, int highest);
+};
+
+#endif // THREADRANDOM_H
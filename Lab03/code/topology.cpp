@@ -0,0 +1,186 @@
+/**
+ * @file topology.cpp
+ * @brief Génération du réseau d'échanges : régions, fan-out et liens hors région.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "topology.h"
+#include "threadrandom.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Premier indice de la région parmi n éléments répartis par blocs contigus
+ */
+int regionBegin(int n, int nbRegions, int region) {
+    return int(static_cast<long long>(n) * region / nbRegions);
+}
+
+/**
+ * @brief Grossiste local voulu, ou, avec la probabilité donnée, un grossiste quelconque
+ */
+int pickWholesaler(int local, int nbWholesalers, double crossRegion) {
+    if (crossRegion > 0.0 && ThreadRandom::bounded(0, 999999) < crossRegion * 1000000) {
+        return ThreadRandom::bounded(0, nbWholesalers - 1);
+    }
+    return local;
+}
+
+/**
+ * @brief Partage d'origine : une tranche de fournisseurs par grossiste, le reste commun à tous
+ */
+void shareByTranches(Topology& topology, int begin, int end, int offset, int wBegin, int wEnd) {
+    int nbLocal = wEnd - wBegin;
+    int byWholesaler = (end - begin) / nbLocal;
+    int shared = (end - begin) % nbLocal;
+    int count = begin;
+
+    for (int w = wBegin; w < wEnd; ++w) {
+        std::vector<int>& suppliers = topology.wholesalerSuppliers[w];
+        for (int s = count; s < count + byWholesaler; ++s) {
+            suppliers.push_back(offset + s);
+        }
+        for (int s = end - shared; s < end; ++s) {
+            suppliers.push_back(offset + s);
+        }
+        count += byWholesaler;
+    }
+}
+
+std::string trim(const std::string& text) {
+    std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return "";
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+}
+
+Topology generateTopology(const TopologyConfig& config) {
+    Topology topology;
+    int nbWholesalers = config.nbWholesalers;
+    int nbRegions = std::max(1, std::min(config.nbRegions, nbWholesalers));
+
+    topology.wholesalerSuppliers.resize(std::max(0, nbWholesalers));
+    topology.factoryWholesalers.resize(std::max(0, config.nbFactories));
+
+    for (int region = 0; region < nbRegions && nbWholesalers > 0; ++region) {
+        int eBegin = regionBegin(config.nbExtractors, nbRegions, region);
+        int eEnd = regionBegin(config.nbExtractors, nbRegions, region + 1);
+        int fBegin = regionBegin(config.nbFactories, nbRegions, region);
+        int fEnd = regionBegin(config.nbFactories, nbRegions, region + 1);
+        int wBegin = regionBegin(nbWholesalers, nbRegions, region);
+        int wEnd = regionBegin(nbWholesalers, nbRegions, region + 1);
+        int nbLocal = wEnd - wBegin;
+
+        /* Fournisseurs des grossistes de la région */
+        if (config.supplierFanOut <= 0) {
+            shareByTranches(topology, eBegin, eEnd, 0, wBegin, wEnd);
+            shareByTranches(topology, fBegin, fEnd, config.nbExtractors, wBegin, wEnd);
+        } else {
+            int fanOut = std::min(config.supplierFanOut, nbLocal);
+            int k = 0;
+            auto link = [&](int supplier) {
+                for (int j = 0; j < fanOut; ++j) {
+                    int w = pickWholesaler(wBegin + (k + j) % nbLocal, nbWholesalers, config.crossRegion);
+                    std::vector<int>& suppliers = topology.wholesalerSuppliers[w];
+                    /* Les liens d'un fournisseur sont ajoutés d'affilée : un doublon serait le dernier */
+                    if (suppliers.empty() || suppliers.back() != supplier) {
+                        suppliers.push_back(supplier);
+                    }
+                }
+                ++k;
+            };
+            for (int e = eBegin; e < eEnd; ++e) {
+                link(e);
+            }
+            for (int f = fBegin; f < fEnd; ++f) {
+                link(config.nbExtractors + f);
+            }
+
+            /* Un grossiste sans fournisseur ne pourrait pas démarrer */
+            int nbSuppliers = (eEnd - eBegin) + (fEnd - fBegin);
+            for (int w = wBegin; w < wEnd && nbSuppliers > 0; ++w) {
+                if (topology.wholesalerSuppliers[w].empty()) {
+                    int s = (w - wBegin) % nbSuppliers;
+                    topology.wholesalerSuppliers[w].push_back(s < eEnd - eBegin ? eBegin + s
+                                                                                : config.nbExtractors + fBegin + s - (eEnd - eBegin));
+                }
+            }
+        }
+
+        /* Grossistes des usines de la région */
+        int fanOut = config.factoryFanOut <= 0 ? nbLocal : std::min(config.factoryFanOut, nbLocal);
+        for (int f = fBegin; f < fEnd; ++f) {
+            std::vector<int>& wholesalers = topology.factoryWholesalers[f];
+            for (int j = 0; j < fanOut; ++j) {
+                int w = pickWholesaler(wBegin + (f - fBegin + j) % nbLocal, nbWholesalers, config.crossRegion);
+                if (config.crossRegion <= 0.0 || std::find(wholesalers.begin(), wholesalers.end(), w) == wholesalers.end()) {
+                    wholesalers.push_back(w);
+                }
+            }
+        }
+    }
+
+    for (const auto& suppliers : topology.wholesalerSuppliers) {
+        topology.nbLinks += suppliers.size();
+    }
+    for (const auto& wholesalers : topology.factoryWholesalers) {
+        topology.nbLinks += wholesalers.size();
+    }
+
+    return topology;
+}
+
+bool loadTopologyConfig(const std::string& path, TopologyConfig& config) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open topology file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::size_t equal = line.find('=');
+        if (equal == std::string::npos) {
+            std::cerr << path << ":" << lineNumber << ": expected key = value" << std::endl;
+            return false;
+        }
+        std::string key = trim(line.substr(0, equal));
+        const char* value = line.c_str() + equal + 1;
+
+        if (key == "extractors") {
+            config.nbExtractors = std::atoi(value);
+        } else if (key == "factories") {
+            config.nbFactories = std::atoi(value);
+        } else if (key == "wholesalers") {
+            config.nbWholesalers = std::atoi(value);
+        } else if (key == "regions") {
+            config.nbRegions = std::atoi(value);
+        } else if (key == "factory_fanout") {
+            config.factoryFanOut = std::atoi(value);
+        } else if (key == "supplier_fanout") {
+            config.supplierFanOut = std::atoi(value);
+        } else if (key == "cross_region") {
+            config.crossRegion = std::atof(value);
+        } else {
+            std::cerr << path << ":" << lineNumber << ": unknown key " << key << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Paramètres du réseau d'échanges entre vendeurs.
+ *
+ * Les vendeurs sont répartis en régions par blocs contigus d'indices. Un grossiste
+ * achète aux mines et usines de sa région, une usine achète aux grossistes de sa
+ * région ; `crossRegion` donne la proportion de liens tirés dans une autre région.
+ * Avec les valeurs par défaut (une région, fan-out à 0) le réseau est celui
+ * d'origine : chaque usine est reliée à tous les grossistes, les vendeurs sont
+ * partagés par tranches entre grossistes, le reste étant commun à tous.
+ */
+struct TopologyConfig {
+    int nbExtractors = 0;
+    int nbFactories = 0;
+    int nbWholesalers = 0;
+    // Nombre de régions, borné par le nombre de grossistes
+    int nbRegions = 1;
+    // Nombre de grossistes auxquels achète chaque usine, 0 pour tous ceux de sa région
+    int factoryFanOut = 0;
+    // Nombre de grossistes auxquels vend chaque mine ou usine, 0 pour le partage par tranches
+    int supplierFanOut = 0;
+    // Probabilité qu'un lien soit tiré hors de la région, entre 0 et 1
+    double crossRegion = 0.0;
+};
+
+/**
+ * @brief Réseau généré, exprimé en indices.
+ *
+ * Les fournisseurs d'un grossiste sont numérotés mines d'abord (0 à nbExtractors - 1),
+ * puis usines (nbExtractors à nbExtractors + nbFactories - 1).
+ */
+struct Topology {
+    // Fournisseurs de chaque grossiste
+    std::vector<std::vector<int>> wholesalerSuppliers;
+    // Grossistes de chaque usine
+    std::vector<std::vector<int>> factoryWholesalers;
+    // Nombre total de liens
+    std::size_t nbLinks = 0;
+};
+
+/**
+ * @brief Génère le réseau décrit par la configuration.
+ *        Les tirages utilisent ThreadRandom, le réseau est donc reproductible pour une graine donnée.
+ * @param config Les paramètres du réseau
+ * @return Le réseau
+ */
+Topology generateTopology(const TopologyConfig& config);
+
+/**
+ * @brief Lit une configuration de réseau dans un fichier texte.
+ *
+ * Une clé par ligne, `clé = valeur`, les lignes vides et commençant par `#` sont ignorées.
+ * Clés : extractors, factories, wholesalers, regions, factory_fanout, supplier_fanout, cross_region.
+ * Les clés absentes gardent la valeur qu'elles avaient dans `config`.
+ *
+ * @param path Le chemin du fichier
+ * @param config La configuration à compléter
+ * @return false si le fichier est illisible ou contient une clé inconnue (message sur std::cerr)
+ */
+bool loadTopologyConfig(const std::string& path, TopologyConfig& config);
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,92 @@
+/**
+ * @file transactionlog.cpp
+ * @brief File bornée de messages de console et leur mise en texte.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "transactionlog.h"
+#include "seller.h"
+
+QString formatLogRecord(const LogRecord& record) {
+    switch (record.kind) {
+    case LogKind::Mined:
+        return QString("%1 ").arg(record.qty) % getItemName(record.item) % " has been mined";
+    case LogKind::Built:
+        return QString("Factory have build %1 new object(s)").arg(record.qty);
+    case LogKind::WouldBuy:
+        return QString("I would like to buy %1 of ").arg(record.qty) % getItemName(record.item) %
+               QString(" which would cost me %1").arg(record.amount);
+    case LogKind::Bought:
+        return QString("I bought %1 ").arg(record.qty) % getItemName(record.item) %
+               QString(" wich costed me %1").arg(record.amount);
+    case LogKind::Sold:
+        return QString("I sold %1 ").arg(record.qty) % getItemName(record.item) %
+               QString(" wich brought me %1").arg(record.amount);
+    case LogKind::SoldBatch:
+        return QString("I sold a batch of %1 lines wich brought me %2").arg(record.qty).arg(record.amount);
+    case LogKind::BidPlaced:
+        return QString("I placed a bid for %1 of ").arg(record.qty) % getItemName(record.item) %
+               QString(" which costs me %1").arg(record.amount);
+    }
+    return QString();
+}
+
+namespace {
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+} // namespace
+
+TransactionLog::TransactionLog(std::size_t capacity)
+    : mask(roundUpToPowerOfTwo(capacity) - 1), cells(std::make_unique<Cell[]>(mask + 1)) {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool TransactionLog::tryPush(const LogRecord& record) {
+    std::uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        std::uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::int64_t>(sequence - pos);
+        if (diff == 0) {
+            /* Case libre à cette position : on la réserve */
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Le consommateur n'a pas encore libéré la case d'il y a un tour : file pleine */
+            nbDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            /* Un autre producteur a pris la position entre-temps */
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->record = record;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool TransactionLog::tryPop(LogRecord& record) {
+    Cell& cell = cells[dequeuePos & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+        return false;
+    }
+
+    record = cell.record;
+    /* La case redevient libre pour la position qui tombe dessus au tour suivant */
+    cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+}
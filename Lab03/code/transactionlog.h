@@ -0,0 +1,92 @@
+/**
+ * @file transactionlog.h
+ * @brief File sans verrou de messages de console binaires, mis en texte par un seul consommateur.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#ifndef TRANSACTIONLOG_H
+#define TRANSACTIONLOG_H
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "itemtype.h"
+
+/**
+ * @brief Nature d'un message de console, qui en fixe le texte
+ */
+enum class LogKind : std::uint8_t {
+    Mined,       // `qty` ressources extraites
+    Built,       // `qty` objets assemblés
+    WouldBuy,    // Intention d'acheter `qty` objets pour `amount`
+    Bought,      // Achat de `qty` objets pour `amount`
+    Sold,        // Vente de `qty` objets pour `amount`
+    SoldBatch,   // Vente d'une commande de `qty` lignes pour `amount`
+    BidPlaced    // Offre d'achat de `qty` objets pour `amount`
+};
+
+/**
+ * @brief Message de console de taille fixe : les valeurs, sans le texte
+ */
+struct LogRecord {
+    std::uint32_t consoleId;
+    LogKind kind;
+    ItemType item;
+    std::int32_t qty;
+    std::int32_t amount;
+};
+
+static_assert(sizeof(LogRecord) <= 24, "A LogRecord must stay small enough to be copied on the trading path");
+
+/**
+ * @brief Met en texte un message de console, tel que l'affiche la console du vendeur
+ */
+QString formatLogRecord(const LogRecord& record);
+
+/**
+ * @brief File bornée de messages, plusieurs producteurs et un seul consommateur.
+ *
+ * Chaque case porte un numéro de séquence : un producteur réserve une position par
+ * compare-and-swap, y copie le message puis publie la case ; le consommateur la lit et
+ * la rend aux producteurs un tour plus loin. Aucun producteur n'attend : si la file est
+ * pleine, le message est compté comme perdu.
+ */
+class TransactionLog
+{
+public:
+    /**
+     * @param capacity Nombre de messages en attente au plus, arrondi à la puissance de deux supérieure
+     */
+    explicit TransactionLog(std::size_t capacity);
+
+    /**
+     * @brief Ajoute un message, depuis n'importe quel thread
+     * @return false si la file est pleine, le message est alors perdu
+     */
+    bool tryPush(const LogRecord& record);
+
+    /**
+     * @brief Retire le plus ancien message publié. À n'appeler que depuis le thread consommateur.
+     * @return false si aucun message n'est prêt
+     */
+    bool tryPop(LogRecord& record);
+
+    std::uint64_t getNbDropped() const { return nbDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::uint64_t> sequence;
+        LogRecord record;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> enqueuePos{0};
+    alignas(CACHE_LINE_SIZE) std::uint64_t dequeuePos = 0;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> nbDropped{0};
+};
+
+#endif // TRANSACTIONLOG_H
@@ -7,9 +7,34 @@
  *
  * Historique des modifications :
  * - Ajout de la méthode `endService` pour demander l'arrêt des threads de manière propre.
+ * - `endService` réveille les vendeurs bloqués en attente d'un évènement.
+ * - Option de place de marché : thread d'appariement lancé avec les vendeurs,
+ *   offres non servies remboursées avant le contrôle des fonds.
+ * - Graine aléatoire configurable et rappelée dans le rapport final.
+ * - Horloge de simulation choisie par les options (temps réel, accéléré, au plus vite).
+ * - Option d'ordonnanceur à évènements discrets : un seul thread exécute tous les vendeurs.
+ * - Option de pool de threads à vol de tâches, dimensionné sur le nombre de cœurs.
+ * - Réseau d'échanges produit par le générateur de topologie (régions, fan-out) au lieu
+ *   du partage par tranches codé en dur, qui reste le réseau par défaut.
+ * - Bilan des ventes par issue et export des statistiques (CSV ou JSON) à l'arrêt.
+ * - Auditeur de la conservation des fonds exécuté pendant la simulation ; le calcul
+ *   du total est partagé avec le contrôle final (`countFunds`).
+ * - Mines et usines créées pour les matières premières et les objets fabriqués du catalogue.
+ * - Politique de réassort des usines choisie par les options ; taux d'utilisation des usines
+ *   dans le rapport final et dans l'export des statistiques.
+ * - Enregistrement optionnel d'un journal binaire des évènements, fermé avec l'état final des vendeurs.
+ * - Option de grossistes à recettes réparties par type d'objet (ShardedWholesale).
+ * - Mode réparti : seuls les vendeurs du processus sont exécutés, les autres sont
+ *   remplacés par des représentants (RemoteSeller) ; bilan de tous les processus.
+ * - Option d'exécution des vendeurs en coroutines sur un seul thread.
+ * - Option de tarification dynamique : prix finaux et nombre d'ajustements dans le rapport.
+ * - Vendeurs construits dans une arène (SellerArena) plutôt qu'alloués un par un.
  */
 
 #include "utils.h"
+#include "threadrandom.h"
+#include <algorithm>
+#include <fstream>
 
 // Dans la méthode `endService`, ajout d'une boucle pour arrêter les threads de manière propre.
 void Utils::endService() {
@@ -17,6 +42,24 @@ void Utils::endService() {
         threads[i]->requestStop();
     }
 
+    // Les vendeurs bloqués en attente de fonds ou de ressources doivent voir la demande d'arrêt
+    for (Extractor* extractor : extractors) {
+        extractor->wakeUp();
+    }
+    for (Factory* factory : factories) {
+        factory->wakeUp();
+    }
+
+    if (eventEngine) {
+        eventEngine->stop();
+    }
+    if (pool) {
+        pool->stop();
+    }
+    if (coroutines) {
+        coroutines->stop();
+    }
+
     std::cout << "It's time to end !" << std::endl;
 }
 
@@ -27,7 +70,7 @@ void Utils::externalEndService() {
 
 }
 
-std::vector<Extractor*> createExtractors(int nbExtractors, int idStart) {
+std::vector<Extractor*> createExtractors(SellerArena& arena, int nbExtractors, int idStart) {
     if (nbExtractors < 1){
         qInfo() << "Cannot make the programm work with less than 1 extractor";
         exit(-1);
@@ -35,27 +78,18 @@ std::vector<Extractor*> createExtractors(int nbExtractors, int idStart) {
 
     std::vector<Extractor*> extractors;
 
-    for(int i = 0; i < nbExtractors; ++i) {
-        switch(i % 3) {
-            case 0:
-                extractors.push_back(new SandExtractor(i + idStart, EXTRACTOR_FUND));
-                break;
-
-            case 1:
-                extractors.push_back(new CopperExtractor(i + idStart, EXTRACTOR_FUND));
-                break;
+    const RecipeBook& book = recipeBook();
 
-            case 2:
-                extractors.push_back(new PetrolExtractor(i + idStart, EXTRACTOR_FUND));
-                break;
-        }
+    /* Les matières premières du catalogue sont réparties à tour de rôle */
+    for(int i = 0; i < nbExtractors; ++i) {
+        ItemType resource = book.rawMaterials[std::size_t(i) % book.nbRawMaterials];
+        extractors.push_back(arena.create<Extractor>(i + idStart, EXTRACTOR_FUND, resource));
     }
 
-
     return extractors;
 }
 
-std::vector<Factory*> createFactories(int nbFactories, int idStart) {
+std::vector<Factory*> createFactories(SellerArena& arena, int nbFactories, int idStart) {
     if (nbFactories < 1){
         qInfo() << "Cannot make the programm work with less than 1 Factory";
         exit(-1);
@@ -63,27 +97,18 @@ std::vector<Factory*> createFactories(int nbFactories, int idStart) {
 
     std::vector<Factory*> factories;
 
-    for(int i = 0; i < nbFactories; ++i) {
-        switch(i % 3) {
-            case 0:
-                factories.push_back(new PlasticFactory(i + idStart, FACTORIES_FUND));
-                break;
-
-            case 1:
-                factories.push_back(new ChipFactory(i + idStart, FACTORIES_FUND));
-                break;
+    const RecipeBook& book = recipeBook();
 
-            case 2:
-                factories.push_back(new RobotFactory(i + idStart, FACTORIES_FUND));
-                break;
-        }
+    /* Les objets fabriqués du catalogue sont répartis à tour de rôle */
+    for(int i = 0; i < nbFactories; ++i) {
+        ItemType product = book.products[std::size_t(i) % book.nbProducts];
+        factories.push_back(arena.create<Factory>(i + idStart, FACTORIES_FUND, product));
     }
 
-
     return factories;
 }
 
-std::vector<Wholesale*> createWholesaler(int nbWholesaler, int idStart) {
+std::vector<Wholesale*> createWholesaler(SellerArena& arena, int nbWholesaler, int idStart, bool sharded) {
     if(nbWholesaler < 1){
         qInfo() << "Cannot launch the programm without any wholesaler";
         exit(-1);
@@ -92,93 +117,478 @@ std::vector<Wholesale*> createWholesaler(int nbWholesaler, int idStart) {
     std::vector<Wholesale*> wholesalers;
 
     for(int i = 0; i < nbWholesaler; ++i){
-        wholesalers.push_back(new Wholesale(i + idStart, WHOLESALERS_FUND));
+        if (sharded) {
+            wholesalers.push_back(arena.create<ShardedWholesale>(i + idStart, WHOLESALERS_FUND));
+        } else {
+            wholesalers.push_back(arena.create<Wholesale>(i + idStart, WHOLESALERS_FUND));
+        }
     }
 
     return wholesalers;
 }
 
 
-Utils::Utils(int nbExtractor, int nbFactory, int nbWholesale) {
-    this->extractors.resize(nbExtractor);
-    this->wholesalers.resize(nbWholesale);
-    this->factories.resize(nbFactory);
+Utils::Utils(int nbExtractor, int nbFactory, int nbWholesale, const SimulationOptions& options)
+    : partition(options.partition), eventLogPath(options.eventLogPath), statsPath(options.statsPath) {
+    ThreadRandom::seed(options.seed);
 
-    this->extractors = createExtractors(nbExtractor, 0);
-    this->wholesalers = createWholesaler(nbWholesale, nbExtractor);
-    this->factories = createFactories(nbFactory, nbExtractor + nbWholesale);
+    if (options.scheduler == SchedulerMode::DiscreteEvent) {
+        auto engine = std::make_unique<DiscreteEventEngine>();
+        engine->setTimeLimit(options.simulatedDurationUs);
+        eventEngine = engine.get();
+        clock = std::move(engine);
+    } else {
+        switch (options.clock) {
+            case ClockMode::RealTime:
+                clock = std::make_unique<RealTimeClock>();
+                break;
+            case ClockMode::Scaled:
+                clock = std::make_unique<ScaledClock>(options.timeScale);
+                break;
+            case ClockMode::Fast:
+                clock = std::make_unique<FastClock>();
+                break;
+        }
+    }
+    Seller::setClock(clock.get());
 
-    for(auto i = factories.begin(); i != factories.end(); ++i) {
-        (*i)->setWholesalers(wholesalers);
+    if (options.scheduler == SchedulerMode::WorkStealing) {
+        pool = std::make_unique<WorkStealingPool>(options.nbWorkers, clock.get());
+    } else if (options.scheduler == SchedulerMode::Coroutines) {
+        coroutines = std::make_unique<CoroutineScheduler>(clock.get());
     }
 
-    int extractorsByWholesaler = nbExtractor / nbWholesale;
-    int extractorsShared = nbExtractor % nbWholesale;
+    if (options.useMarketplace) {
+        marketplace = std::make_unique<Marketplace>();
+    }
+    Seller::setMarketplace(marketplace.get());
+    Factory::setReorderPolicy(options.reorder);
+
+    if (options.pricing.enabled) {
+        pricing = std::make_unique<PricingEngine>(options.pricing, clock.get());
+    }
+    PricingEngine::setActive(pricing.get());
 
-    int factoriesByWholesaler = nbFactory / nbWholesale;
-    int factoriesShared = nbFactory % nbWholesale;
+    this->extractors.resize(nbExtractor);
+    this->wholesalers.resize(nbWholesale);
+    this->factories.resize(nbFactory);
 
-    int countExtractor = 0;
-    int countFactory = 0;
+    this->extractors = createExtractors(sellerArena, nbExtractor, 0);
+    this->wholesalers = createWholesaler(sellerArena, nbWholesale, nbExtractor, options.shardedWholesalers);
+    this->factories = createFactories(sellerArena, nbFactory, nbExtractor + nbWholesale);
+
+    TopologyConfig topologyConfig = options.topology;
+    topologyConfig.nbExtractors = nbExtractor;
+    topologyConfig.nbFactories = nbFactory;
+    topologyConfig.nbWholesalers = nbWholesale;
+    Topology topology = generateTopology(topologyConfig);
+
+    /* Vendeurs par identifiant ; ceux des autres processus sont remplacés par leur représentant */
+    std::vector<Seller*> sellersById(extractors.begin(), extractors.end());
+    sellersById.insert(sellersById.end(), wholesalers.begin(), wholesalers.end());
+    sellersById.insert(sellersById.end(), factories.begin(), factories.end());
+    auto isLocal = [this](Seller* seller) { return !partition || partition->owns(seller->getUniqueId()); };
+    for (Seller*& seller : sellersById) {
+        if (!isLocal(seller)) {
+            seller = partition->createProxy(seller->getUniqueId());
+        }
+    }
 
-    for(auto& w : wholesalers) {
+    std::vector<Seller*> factoryWholesalers;
+    for (std::size_t f = 0; f < factories.size(); ++f) {
+        if (!isLocal(factories[f])) {
+            continue;
+        }
+        factoryWholesalers.clear();
+        for (int w : topology.factoryWholesalers[f]) {
+            factoryWholesalers.push_back(sellersById[nbExtractor + w]);
+        }
+        factories[f]->setWholesalers(factoryWholesalers);
+    }
 
-        std::vector<Extractor*> tmpExtractors(extractors.begin() + countExtractor, extractors.begin() + countExtractor + extractorsByWholesaler);
-        tmpExtractors.insert(tmpExtractors.end(), extractors.end() - extractorsShared, extractors.end());
+    std::vector<Seller*> sellers;
+    for (std::size_t w = 0; w < wholesalers.size(); ++w) {
+        if (!isLocal(wholesalers[w])) {
+            continue;
+        }
+        sellers.clear();
+        for (int s : topology.wholesalerSuppliers[w]) {
+            if (s < nbExtractor) {
+                sellers.push_back(sellersById[s]);
+            } else {
+                sellers.push_back(sellersById[nbWholesale + s]);
+            }
+        }
+        wholesalers[w]->setSellers(sellers);
+    }
 
-        std::vector<Factory*> tmpFactories(factories.begin() + countFactory, factories.begin() + countFactory + factoriesByWholesaler);
-        tmpFactories.insert(tmpFactories.end(), factories.end() - factoriesShared, factories.end());
+    if (partition) {
+        /* Les vendeurs des autres processus ne servaient qu'à reproduire le même réseau */
+        auto dropRemote = [this, &isLocal](auto& group) {
+            auto remote = std::stable_partition(group.begin(), group.end(), isLocal);
+            std::for_each(remote, group.end(), [this](Seller* seller) { sellerArena.destroy(seller); });
+            group.erase(remote, group.end());
+        };
+        dropRemote(extractors);
+        dropRemote(wholesalers);
+        dropRemote(factories);
+        partition->serve(sellersById);
+    }
 
-        countExtractor += extractorsByWholesaler;
-        countFactory += factoriesByWholesaler;
+    if (options.auditPeriodUs > 0) {
+        auditor = std::make_unique<FundsAuditor>([this]() { return static_cast<long long>(countFunds()); },
+                                                 getStartFund(), options.auditPeriodUs);
+    }
 
-        std::vector<Seller*> sellers;
-        for (auto& m : tmpExtractors)
-            sellers.push_back(static_cast<Seller*>(m));
-        for (auto& f : tmpFactories)
-            sellers.push_back(static_cast<Seller*>(f));
-        w->setSellers(sellers);
+    if (!eventLogPath.empty()) {
+        EventLogHeader header;
+        header.nbExtractors = std::uint32_t(nbExtractor);
+        header.nbFactories = std::uint32_t(nbFactory);
+        header.nbWholesalers = std::uint32_t(nbWholesale);
+        header.seed = ThreadRandom::getSeed();
+        eventLog = std::make_unique<EventLog>(eventLogPath, header, clock.get());
+        EventLog::setActive(eventLog.get());
     }
 
     utilsThread = std::make_unique<PcoThread>(&Utils::run, this);
 }
 
 void Utils::run() {
-    for(size_t i = 0; i < extractors.size(); ++i) {
-        threads.emplace_back(std::make_unique<PcoThread>(&Extractor::run, extractors[i]));
+    if (marketplace) {
+        marketplaceThread = std::make_unique<PcoThread>(&Marketplace::run, marketplace.get());
     }
-    for(size_t i = 0; i < factories.size(); ++i) {
-        threads.emplace_back(std::make_unique<PcoThread>(&Factory::run, factories[i]));
+    if (auditor) {
+        auditorThread = std::make_unique<PcoThread>(&FundsAuditor::run, auditor.get());
     }
-    for(size_t i = 0; i < wholesalers.size(); ++i) {
-        threads.emplace_back(std::make_unique<PcoThread>(&Wholesale::run, wholesalers[i]));
+
+    if (eventEngine) {
+        for (Extractor* extractor : extractors) {
+            eventEngine->addSeller(extractor);
+        }
+        for (Factory* factory : factories) {
+            eventEngine->addSeller(factory);
+        }
+        for (Wholesale* wholesale : wholesalers) {
+            eventEngine->addSeller(wholesale);
+        }
+        threads.emplace_back(std::make_unique<PcoThread>(&DiscreteEventEngine::run, eventEngine));
+    } else if (pool) {
+        for (Extractor* extractor : extractors) {
+            pool->addSeller(extractor);
+        }
+        for (Factory* factory : factories) {
+            pool->addSeller(factory);
+        }
+        for (Wholesale* wholesale : wholesalers) {
+            pool->addSeller(wholesale);
+        }
+        threads.emplace_back(std::make_unique<PcoThread>(&WorkStealingPool::run, pool.get()));
+    } else if (coroutines) {
+        for (Extractor* extractor : extractors) {
+            coroutines->addSeller(extractor);
+        }
+        for (Factory* factory : factories) {
+            coroutines->addSeller(factory);
+        }
+        for (Wholesale* wholesale : wholesalers) {
+            coroutines->addSeller(wholesale);
+        }
+        threads.emplace_back(std::make_unique<PcoThread>(&CoroutineScheduler::run, coroutines.get()));
+    } else {
+        for(size_t i = 0; i < extractors.size(); ++i) {
+            threads.emplace_back(std::make_unique<PcoThread>(&Extractor::run, extractors[i]));
+        }
+        for(size_t i = 0; i < factories.size(); ++i) {
+            threads.emplace_back(std::make_unique<PcoThread>(&Factory::run, factories[i]));
+        }
+        for(size_t i = 0; i < wholesalers.size(); ++i) {
+            threads.emplace_back(std::make_unique<PcoThread>(&Wholesale::run, wholesalers[i]));
+        }
     }
 
     for (auto& thread : threads) {
         thread->join();
     }
 
-    int startFund = (EXTRACTOR_FUND * int(extractors.size()) + (FACTORIES_FUND * int(factories.size()) + (WHOLESALERS_FUND * int(wholesalers.size()))));
-    int endFund = 0;
+    // Les autres processus peuvent encore acheter à nos vendeurs tant qu'ils tournent
+    if (partition) {
+        partition->close();
+    }
+
+    // Les vendeurs sont arrêtés : plus aucune offre ne sera déposée
+    if (marketplace) {
+        marketplace->stop();
+        marketplaceThread->join();
+        marketplace->refundPendingBids();
+    }
+    if (auditor) {
+        auditor->stop();
+        auditorThread->join();
+    }
+
+    int startFund = getStartFund();
+    int endFund = countFunds();
+
+    finalReport = QString("The expected fund is : %1 and you got at the end : %2").arg(startFund).arg(endFund);
+    finalReport += QString("\nRandom seed : %1").arg(ThreadRandom::getSeed());
+    finalReport += QString("\nSimulated time : %1 s").arg(clock->now() / 1e6);
+
+    if (marketplace) {
+        finalReport += QString("\nMarketplace fills : %1, failed trades : %2")
+                           .arg(marketplace->getNbFills()).arg(marketplace->getNbFailedTrades());
+    }
+
+    if (auditor) {
+        finalReport += QString("\nFunds audits : %1 consistent, %2 skipped, %3 violations (%4 retries)")
+                           .arg(auditor->getNbAudits()).arg(auditor->getNbSkipped())
+                           .arg(auditor->getNbViolations()).arg(auditor->getNbRetries());
+    }
+
+    TradeCounts trades = getTradeCounts();
+    finalReport += QString("\nTrades : %1 sold, %2 out of stock, %3 wrong item, %4 invalid quantity")
+                       .arg(trades[std::size_t(TradeOutcome::Success)])
+                       .arg(trades[std::size_t(TradeOutcome::OutOfStock)])
+                       .arg(trades[std::size_t(TradeOutcome::WrongItem)])
+                       .arg(trades[std::size_t(TradeOutcome::InvalidQuantity)]);
+
+    if (partition) {
+        PartitionSummary local;
+        local.startFund = startFund;
+        local.endFund = endFund;
+        local.nbSold = trades[std::size_t(TradeOutcome::Success)];
+        std::vector<PartitionSummary> summaries = partition->exchangeSummaries(local);
+
+        if (partition->isMain()) {
+            PartitionSummary total;
+            for (const PartitionSummary& summary : summaries) {
+                total.startFund += summary.startFund;
+                total.endFund += summary.endFund;
+                total.paidToPeers += summary.paidToPeers;
+                total.receivedFromPeers += summary.receivedFromPeers;
+                total.nbSold += summary.nbSold;
+                total.nbRemoteCalls += summary.nbRemoteCalls;
+                total.remoteCallNs += summary.remoteCallNs;
+                total.nbRestockPolls += summary.nbRestockPolls;
+            }
+            finalReport += QString("\nPartitions : %1 processes, expected fund %2, got %3, %4 sold")
+                               .arg(summaries.size()).arg(total.startFund).arg(total.endFund).arg(total.nbSold);
+            finalReport += QString("\nRemote calls : %1 (%2 us average), %3 paid to other processes, %4 received")
+                               .arg(total.nbRemoteCalls)
+                               .arg(total.nbRemoteCalls ? total.remoteCallNs / 1e3 / total.nbRemoteCalls : 0.0, 0, 'f', 2)
+                               .arg(total.paidToPeers).arg(total.receivedFromPeers);
+            finalReport += QString("\nRestock polls : %1, every %2 us per watched remote seller")
+                               .arg(total.nbRestockPolls).arg(PARTITION_RESTOCK_POLL_US);
+        }
+    }
+
+    if (!factories.empty()) {
+        double total = 0.0, lowest = 1.0, highest = 0.0;
+        std::uint64_t nbPrefetches = 0;
+        for (Factory* factory : factories) {
+            double utilization = factory->getUtilization();
+            total += utilization;
+            lowest = std::min(lowest, utilization);
+            highest = std::max(highest, utilization);
+            nbPrefetches += factory->getNbPrefetches();
+        }
+        finalReport += QString("\nFactories : %1 % average utilization (min %2 %, max %3 %), %4 prefetch orders")
+                           .arg(100.0 * total / factories.size(), 0, 'f', 1)
+                           .arg(100.0 * lowest, 0, 'f', 1).arg(100.0 * highest, 0, 'f', 1)
+                           .arg(nbPrefetches);
+    }
+
+    if (!statsPath.empty()) {
+        if (writeStatsReport(statsPath)) {
+            finalReport += QString("\nStatistics written to %1").arg(QString::fromStdString(statsPath));
+        } else {
+            finalReport += QString("\nCannot write statistics to %1").arg(QString::fromStdString(statsPath));
+        }
+    }
+
+    if (eventLog) {
+        if (closeEventLog()) {
+            finalReport += QString("\nEvent log : %1 events written to %2")
+                               .arg(eventLog->getNbRecords()).arg(QString::fromStdString(eventLogPath));
+        } else {
+            finalReport += QString("\nCannot write event log %1").arg(QString::fromStdString(eventLogPath));
+        }
+    }
+
+    if (eventEngine) {
+        finalReport += QString("\nDiscrete events : %1").arg(eventEngine->getNbEvents());
+    }
+    if (pool) {
+        finalReport += QString("\nPool : %1 workers, %2 steps, %3 steals")
+                           .arg(pool->getNbWorkers()).arg(pool->getNbSteps()).arg(pool->getNbSteals());
+    }
+    if (coroutines) {
+        finalReport += QString("\nCoroutines : %1 routines, %2 steps, %3 bytes of frames (%4 per routine)")
+                           .arg(coroutines->getNbRoutines()).arg(coroutines->getNbSteps())
+                           .arg(coroutines->getFrameBytes())
+                           .arg(coroutines->getNbRoutines() ? coroutines->getFrameBytes() / coroutines->getNbRoutines() : 0);
+    }
+    if (pricing) {
+        finalReport += QString("\nPrices (catalogue -> final), %1 repricings :").arg(pricing->getNbRepricings());
+        for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+            ItemType item = static_cast<ItemType>(i);
+            finalReport += QString(" %1 %2 -> %3").arg(getItemName(item))
+                               .arg(recipeBook().costs[RecipeBook::index(item)]).arg(pricing->getPrice(item));
+        }
+        // Les vendeurs sont arrêtés : plus personne ne lit les prix
+        PricingEngine::setActive(nullptr);
+    }
+
+    /* Les fonds d'un seul processus ne sont qu'une part du total : seul le principal les annonce */
+    if (!partition || partition->isMain()) {
+        qInfo() << "The expected fund is : " << startFund << " and you got at the end : " << endFund;
+    }
+    finished = true;
+    semEnd.release();
+}
+
+TradeCounts Utils::getTradeCounts() const {
+    TradeCounts trades{};
+    auto countTrades = [&trades](const Seller* seller) {
+        for (std::size_t i = 0; i < trades.size(); ++i) {
+            trades[i] += seller->getStats().getNbTrades(TradeOutcome(i));
+        }
+    };
+    std::for_each(extractors.begin(), extractors.end(), countTrades);
+    std::for_each(factories.begin(), factories.end(), countTrades);
+    std::for_each(wholesalers.begin(), wholesalers.end(), countTrades);
+    return trades;
+}
+
+int Utils::getStartFund() const {
+    return (EXTRACTOR_FUND * int(extractors.size()) + (FACTORIES_FUND * int(factories.size()) + (WHOLESALERS_FUND * int(wholesalers.size()))));
+}
+
+int Utils::countFunds() const {
+    int total = 0;
 
     for(Extractor* extractor: extractors) {
-        endFund += extractor->getFund();
-        endFund += extractor->getAmountPaidToMiners();
+        total += extractor->getFund();
+        total += extractor->getAmountPaidToMiners();
     }
 
     for(Factory* factory: factories) {
-        endFund += factory->getFund();
-        endFund += factory->getAmountPaidToWorkers();
+        total += factory->getFund();
+        total += factory->getAmountPaidToWorkers();
     }
 
     for(Wholesale* wholesale : wholesalers) {
-        endFund += wholesale->getFund();
+        total += wholesale->getFund();
     }
 
-    finalReport = QString("The expected fund is : %1 and you got at the end : %2").arg(startFund).arg(endFund);
+    if (marketplace) {
+        total += marketplace->getEscrow();
+    }
 
-    qInfo() << "The expected fund is : " << startFund << " and you got at the end : " << endFund;
-    semEnd.release();
+    if (partition) {
+        total += int(partition->getNetPaidToPeers());
+    }
+
+    return total;
+}
+
+bool Utils::writeStatsReport(const std::string& path) const {
+    struct Row {
+        std::string kind;
+        int id;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    auto addHistogram = [](Row& row, const std::string& prefix, const LatencyHistogram& histogram) {
+        row.metrics.emplace_back(prefix + "_count", double(histogram.getCount()));
+        row.metrics.emplace_back(prefix + "_mean_us", histogram.getMeanUs());
+        row.metrics.emplace_back(prefix + "_p50_us", double(histogram.getPercentileUs(0.5)));
+        row.metrics.emplace_back(prefix + "_p99_us", double(histogram.getPercentileUs(0.99)));
+        row.metrics.emplace_back(prefix + "_max_us", double(histogram.getMaxUs()));
+    };
+
+    auto sellerRow = [&addHistogram](const char* kind, Seller* seller) {
+        const SellerStats& stats = seller->getStats();
+        Row row{kind, seller->getUniqueId(), {}};
+        row.metrics.emplace_back("fund", seller->getFund());
+        row.metrics.emplace_back("trades_sold", double(stats.getNbTrades(TradeOutcome::Success)));
+        row.metrics.emplace_back("trades_out_of_stock", double(stats.getNbTrades(TradeOutcome::OutOfStock)));
+        row.metrics.emplace_back("trades_wrong_item", double(stats.getNbTrades(TradeOutcome::WrongItem)));
+        row.metrics.emplace_back("trades_invalid_quantity", double(stats.getNbTrades(TradeOutcome::InvalidQuantity)));
+        row.metrics.emplace_back("stock_cas_retries", double(seller->getNbStockRetries()));
+        row.metrics.emplace_back("fund_cas_retries", double(stats.fundRetries.load()));
+        addHistogram(row, "wakeup_wait", stats.wakeupWait);
+        return row;
+    };
+
+    std::vector<Row> rows;
+    for (Extractor* extractor : extractors) {
+        rows.push_back(sellerRow("extractor", extractor));
+    }
+    for (Factory* factory : factories) {
+        rows.push_back(sellerRow("factory", factory));
+        addHistogram(rows.back(), "order_latency", factory->getOrderLatency());
+        rows.back().metrics.emplace_back("utilization", factory->getUtilization());
+        rows.back().metrics.emplace_back("prefetch_orders", double(factory->getNbPrefetches()));
+    }
+    for (Wholesale* wholesale : wholesalers) {
+        rows.push_back(sellerRow("wholesaler", wholesale));
+    }
+    if (marketplace) {
+        rows.push_back({"marketplace", -1, {}});
+        addHistogram(rows.back(), "lock_wait", marketplace->getLockWait());
+        addHistogram(rows.back(), "lock_hold", marketplace->getLockHold());
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    file.precision(12);
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+        file << "{\n  \"seed\": " << ThreadRandom::getSeed() << ",\n  \"rows\": [";
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            file << (i ? ",\n" : "\n") << "    {\"kind\": \"" << rows[i].kind << "\", \"id\": " << rows[i].id;
+            for (const auto& metric : rows[i].metrics) {
+                file << ", \"" << metric.first << "\": " << metric.second;
+            }
+            file << "}";
+        }
+        file << "\n  ]\n}\n";
+    } else {
+        /* Format long : une ligne par mesure, facile à filtrer et à pivoter */
+        file << "kind,id,metric,value\n";
+        for (const Row& row : rows) {
+            for (const auto& metric : row.metrics) {
+                file << row.kind << "," << row.id << "," << metric.first << "," << metric.second << "\n";
+            }
+        }
+    }
+
+    return bool(file);
+}
+
+bool Utils::closeEventLog() {
+    auto recordFinalState = [](Seller* seller) {
+        EventLog::record(EventKind::FinalFund, seller->getUniqueId(), -1, ItemType::Nothing, 0, seller->getFund());
+        for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+            ItemType item = static_cast<ItemType>(i);
+            EventLog::record(EventKind::FinalStock, seller->getUniqueId(), -1, item, seller->getStock(item), 0);
+        }
+    };
+
+    for (Extractor* extractor : extractors) {
+        recordFinalState(extractor);
+    }
+    for (Factory* factory : factories) {
+        recordFinalState(factory);
+    }
+    for (Wholesale* wholesale : wholesalers) {
+        recordFinalState(wholesale);
+    }
+
+    return eventLog->close();
 }
 
 QString Utils::getFinalReport()
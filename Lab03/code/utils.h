@@ -1,6 +1,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <QRandomGenerator>
 #include <iostream>
@@ -12,6 +14,17 @@
 #include "factory.h"
 #include "wholesale.h"
 #include "seller.h"
+#include "marketplace.h"
+#include "simulationclock.h"
+#include "discreteeventengine.h"
+#include "workstealingpool.h"
+#include "coroutinescheduler.h"
+#include "topology.h"
+#include "fundsauditor.h"
+#include "eventlog.h"
+#include "partition.h"
+#include "pricingengine.h"
+#include "sellerarena.h"
 
 #define NB_EXTRACTOR 3
 #define NB_FACTORIES 3
@@ -20,16 +33,95 @@
 #define FACTORIES_FUND 300
 #define WHOLESALERS_FUND 250
 
-std::vector<Extractor*> createExtractors(int nbExtractors, int idStart);
-std::vector<Factory*> createFactories(int nbFactories, int idStart);
-std::vector<Wholesale*> createWholesaler(int nbWholesaler, int idStart);
+/**
+ * @brief Horloges disponibles pour rythmer la simulation
+ */
+enum class ClockMode {
+    RealTime, // Les pauses durent le temps indiqué
+    Scaled,   // Les pauses sont divisées par SimulationOptions::timeScale
+    Fast      // Les pauses ne coûtent aucun temps réel
+};
+
+/**
+ * @brief Manières d'exécuter les routines des vendeurs
+ */
+enum class SchedulerMode {
+    Threads,      // Un thread par vendeur
+    DiscreteEvent, // Un seul thread, étapes ordonnées par date simulée (DiscreteEventEngine)
+    WorkStealing,  // Étapes exécutées comme tâches sur un pool de threads (WorkStealingPool)
+    Coroutines     // Un seul thread, une coroutine par vendeur (CoroutineScheduler)
+};
+
+/**
+ * @brief Options de la simulation, communes aux versions graphique et sans affichage
+ */
+struct SimulationOptions {
+    // Échanges au travers d'un carnet d'ordres central plutôt qu'en direct entre vendeurs
+    bool useMarketplace = false;
+    // Graine des générateurs aléatoires, 0 pour en tirer une au hasard
+    std::uint64_t seed = 0;
+    // Horloge de la simulation
+    ClockMode clock = ClockMode::RealTime;
+    // Secondes simulées par seconde réelle, pour ClockMode::Scaled
+    double timeScale = 1.0;
+    // Exécution des vendeurs ; l'ordonnanceur à évènements remplace alors l'horloge choisie
+    SchedulerMode scheduler = SchedulerMode::Threads;
+    // Durée simulée après laquelle l'ordonnanceur à évènements s'arrête seul, 0 pour aucune
+    std::uint64_t simulatedDurationUs = 0;
+    // Nombre de threads du pool à vol de tâches, 0 pour le nombre de cœurs
+    unsigned nbWorkers = 0;
+    // Forme du réseau d'échanges ; les effectifs sont ceux passés au constructeur de Utils
+    TopologyConfig topology;
+    // Fichier où exporter les statistiques des vendeurs à l'arrêt (JSON si l'extension est .json,
+    // CSV sinon), vide pour ne rien exporter
+    std::string statsPath;
+    // Temps réel entre deux audits de la conservation des fonds (µs), 0 pour ne pas auditer
+    std::uint64_t auditPeriodUs = 100000;
+    // Réassort des ressources des usines
+    ReorderPolicy reorder;
+    // Journal binaire des évènements à enregistrer, vide pour ne rien enregistrer
+    std::string eventLogPath;
+    // Grossistes dont les recettes sont réparties par type d'objet (ShardedWholesale)
+    bool shardedWholesalers = false;
+    // Place de ce processus quand les vendeurs sont répartis entre plusieurs processus
+    // (Partition::spawn), nullptr si la simulation tient dans un seul
+    Partition* partition = nullptr;
+    // Prix ajustés à l'offre et à la demande (PricingEngine)
+    PricingConfig pricing;
+};
+
+// Nombre de demandes de vente par issue (indice : TradeOutcome)
+using TradeCounts = std::array<std::uint64_t, std::size_t(TradeOutcome::NbOutcomes)>;
+
+/**
+ * Les vendeurs sont construits dans `arena`, qui les détient et les détruit avec elle.
+ */
+std::vector<Extractor*> createExtractors(SellerArena& arena, int nbExtractors, int idStart);
+std::vector<Factory*> createFactories(SellerArena& arena, int nbFactories, int idStart);
+/**
+ * @param sharded Crée des ShardedWholesale, dont les recettes sont réparties par type d'objet
+ */
+std::vector<Wholesale*> createWholesaler(SellerArena& arena, int nbWholesaler, int idStart, bool sharded = false);
 
 class Utils {
 public:
     void externalEndService();
     QString getFinalReport();
 
+    /**
+     * @brief Indique si la simulation s'est terminée d'elle-même (durée simulée atteinte)
+     */
+    bool isFinished() const { return finished.load(); }
+
+    /**
+     * @brief Demandes de vente reçues par l'ensemble des vendeurs, par issue
+     */
+    TradeCounts getTradeCounts() const;
+
 private:
+    // Mémoire des vendeurs, libérée en dernier
+    SellerArena sellerArena;
+
     std::vector<Extractor*> extractors;
     std::vector<Factory*> factories;
     std::vector<Wholesale*> wholesalers;
@@ -37,15 +129,68 @@ private:
     std::vector<std::unique_ptr<PcoThread>> threads;
     std::unique_ptr<PcoThread> utilsThread;
 
+    // Horloge de la simulation
+    std::unique_ptr<SimulationClock> clock;
+    // Ordonnanceur à évènements discrets, qui est alors aussi l'horloge ; nullptr en mode threads
+    DiscreteEventEngine* eventEngine = nullptr;
+    // Pool qui exécute les vendeurs en mode SchedulerMode::WorkStealing
+    std::unique_ptr<WorkStealingPool> pool;
+    // Exécuteur des vendeurs en mode SchedulerMode::Coroutines
+    std::unique_ptr<CoroutineScheduler> coroutines;
+
+    // Place de marché et son thread d'appariement, si elle est activée
+    std::unique_ptr<Marketplace> marketplace;
+    std::unique_ptr<PcoThread> marketplaceThread;
+
+    // Auditeur des fonds et son thread, si l'audit est activé
+    std::unique_ptr<FundsAuditor> auditor;
+    std::unique_ptr<PcoThread> auditorThread;
+
+    // Processus de la simulation répartie auquel appartiennent les vendeurs ci-dessus, s'il y en a plusieurs
+    Partition* partition = nullptr;
+
+    // Moteur de tarification dynamique, si elle est activée
+    std::unique_ptr<PricingEngine> pricing;
+
+    // Journal des évènements, si l'enregistrement est demandé
+    std::unique_ptr<EventLog> eventLog;
+    std::string eventLogPath;
+
     QString finalReport;
+    std::atomic<bool> finished{false};
 
     void endService();
 
     void run();
 
+    /**
+     * @brief Exporte les statistiques des vendeurs et de la place de marché
+     * @return false si le fichier n'a pas pu être écrit
+     */
+    bool writeStatsReport(const std::string& path) const;
+
+    /**
+     * @brief Inscrit au journal les fonds et stocks finaux de chaque vendeur, puis le ferme
+     * @return false si le journal n'a pas pu être écrit
+     */
+    bool closeEventLog();
+
+    /**
+     * @brief Total des fonds au lancement
+     */
+    int getStartFund() const;
+
+    /**
+     * @brief Total des fonds, salaires versés et séquestre, plus l'argent payé net aux autres
+     *        processus ; égal à getStartFund() si l'argent est conservé
+     */
+    int countFunds() const;
+
+    std::string statsPath;
+
     PcoSemaphore semEnd{0};
 public:
-    Utils(int nbExtractor, int nbFactory, int nbWholesale);
+    Utils(int nbExtractor, int nbFactory, int nbWholesale, const SimulationOptions& options = SimulationOptions());
 
 
 };
@@ -12,15 +12,34 @@
  *   via l'utilisation de `PcoThread::thisThread()->stopRequested()`.
  * - Extension de la méthode `trade` pour inclure la logique de transaction complète,
  *   y compris la mise à jour de l'interface utilisateur après une vente.
+ * - Remplacement du mutex par un compteur atomique par ressource, réservé par compare-and-swap.
+ * - Chaque achat publie un réassort qui réveille les usines abonnées.
+ * - Mode place de marché : offres d'achat sur ce que proposent les vendeurs liés,
+ *   revente systématique de ce qui est livré.
+ * - Quantités et pauses tirées du générateur par thread (ThreadRandom) au lieu de `rand()`.
+ * - Les pauses passent par l'horloge de simulation injectée (Seller::setClock).
+ * - La routine est découpée en étapes (`step`), exécutables par l'ordonnanceur à évènements discrets.
+ * - `trade` compte chaque demande selon son issue dans les statistiques du vendeur.
+ * - Achats et offres d'achat encadrés comme transferts pour l'audit des fonds en cours de simulation.
+ * - Achats inscrits au journal d'évènements.
+ * - Variante ShardedWholesale : recettes réparties par type d'objet, sur des lignes de cache séparées.
+ * - Messages des échanges passés à l'interface sous forme binaire (`logTransaction`), sans mise en texte.
+ * - Achats couverts par les fonds comptés comme demande par la tarification dynamique ; prix lu une fois par vente.
+ * - Achats directs passés en commande d'une ligne, facturée au plus au prix vérifié avant l'achat.
+ * - Achat direct vérifié sur les fonds encaissés, sans les recettes non réglées.
  */
 
 #include "wholesale.h"
 #include "factory.h"
-#include "costs.h"
+#include "eventlog.h"
+#include "pricingengine.h"
+#include "marketplace.h"
+#include "moneyledger.h"
+#include <algorithm>
 #include <iostream>
-#include <pcosynchro/pcothread.h>
+#include "threadrandom.h"
 
-WindowInterface* Wholesale::interface = nullptr;
+SimulationInterface* Wholesale::interface = nullptr;
 
 Wholesale::Wholesale(int uniqueId, int fund)
     : Seller(fund, uniqueId)
@@ -39,6 +58,11 @@ void Wholesale::setSellers(std::vector<Seller*> sellers) {
 }
 
 void Wholesale::buyResources() {
+    if (market) {
+        bidOnMarketplace();
+        return;
+    }
+
     auto s = Seller::chooseRandomSeller(sellers);
     auto m = s->getItemsForSale();
     auto i = Seller::chooseRandomItem(m);
@@ -48,87 +72,206 @@ void Wholesale::buyResources() {
         return;
     }
 
-    int qty = rand() % 5 + 1;
-    int price = qty * getCostPerUnit(i);
+    int qty = ThreadRandom::bounded(1, WHOLESALE_MAX_BID);
+    /* Commande d'une ligne : le vendeur ne peut facturer plus que le prix vérifié ici */
+    Order order;
+    order.add(i, qty);
+    int price = order.cost();
 
-    interface->consoleAppendText(uniqueId, QString("I would like to buy %1 of ").arg(qty) %
-                                 getItemName(i) % QString(" which would cost me %1").arg(price));
+    interface->logTransaction({unsigned(uniqueId), LogKind::WouldBuy, i, qty, price});
 
-    resourcesProtector.lock(); // Début S.C.
-    if (money < price) {
-        resourcesProtector.unlock(); // Fin S.C.
+    /* Seul l'argent encaissé est débité : les recettes d'un ShardedWholesale pas encore réglées
+       (comptées par getFund) ne peuvent pas payer la facture */
+    if (money.load() < price) {
         return;
     }
-    resourcesProtector.unlock(); // Fin S.C.
+    /* Seul un achat que le grossiste peut payer compte comme demande */
+    PricingEngine::recordDemand(i, qty);
 
-    int bill = s->trade(i, qty);
+    int bill;
+    {
+        /* Le vendeur est crédité avant que le grossiste ne soit débité */
+        LedgerTransfer transfer;
+        bill = s->tradeBatch(order, BatchMode::AllOrNothing);
+        money -= bill;
+    }
 
     if (bill == 0) {
         return;
     }
 
-    resourcesProtector.lock(); // Début S.C.
-    money -= bill;
-    stocks[i] += qty;
-    resourcesProtector.unlock(); // Fin S.C.
+    EventLog::record(EventKind::Sale, s->getUniqueId(), uniqueId, i, qty, bill);
+    restock(i, qty);
 }
 
+void Wholesale::bidOnMarketplace() {
+    ItemsForSale offers = market->getOffers(sellers);
+
+    for (std::size_t i = 0; i < NB_ITEM_TYPES; ++i) {
+        ItemType item = static_cast<ItemType>(i);
+
+        if (offers[i] <= 0 || onOrder.get(item) > 0) {
+            continue;
+        }
+
+        int qty = std::min(offers[i], WHOLESALE_MAX_BID);
+        qty = std::min(qty, getFund() / getCostPerUnit(item));
+        int price = qty * getCostPerUnit(item);
 
-void Wholesale::run() {
+        /* Le prix quitte les fonds avant d'entrer en séquestre */
+        LedgerTransfer transfer;
+        if (qty <= 0 || !tryPay(price)) {
+            continue;
+        }
+
+        onOrder.add(item, qty);
+        market->postBid(this, item, qty, &sellers);
+        interface->logTransaction({unsigned(uniqueId), LogKind::BidPlaced, item, qty, price});
+    }
+}
 
+void Wholesale::deliver(ItemType item, int qty) {
+    Seller::deliver(item, qty);
+    market->postAsk(this, item, qty);
+}
+
+bool Wholesale::start() {
     if (sellers.empty()) {
         std::cerr << "You have to give factories and mines to a wholeseler before launching is routine" << std::endl;
-        return;
+        return false;
     }
 
     interface->consoleAppendText(uniqueId, "[START] Wholesaler routine");
-    while (!PcoThread::thisThread()->stopRequested()) {
-        buyResources();
-        interface->updateFund(uniqueId, money);
-        interface->updateStock(uniqueId, &stocks);
-        //Temps de pause pour espacer les demandes de ressources
-        PcoThread::usleep((rand() % 10 + 1) * 100000);
-    }
-    interface->consoleAppendText(uniqueId, "[STOP] Wholesaler routine");
+    ThreadRandom::bindStream(uniqueId);
+    return true;
+}
 
+Step Wholesale::step() {
+    buyResources();
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+    //Temps de pause pour espacer les demandes de ressources
+    return Step::sleep(ThreadRandom::bounded(1, 10) * 100000);
+}
 
+void Wholesale::finish() {
+    interface->consoleAppendText(uniqueId, "[STOP] Wholesaler routine");
 }
 
-std::map<ItemType, int> Wholesale::getItemsForSale() {
-    return stocks;
+ItemsForSale Wholesale::getItemsForSale() {
+    return stocks.snapshot();
 }
 
 int Wholesale::trade(ItemType it, int qty) {
-    bool isAnItemForSale = false;
-
-    for(auto item : getItemsForSale()) {
-        if (it == item.first) {
-            isAnItemForSale = true;
-            break;
-        }
+    if (qty <= 0) {
+        stats.countTrade(TradeOutcome::InvalidQuantity);
+        return 0;
+    }
+    if (it == ItemType::Nothing) {
+        stats.countTrade(TradeOutcome::WrongItem);
+        return 0;
     }
 
-    if (qty <= 0 || !isAnItemForSale) {
+    if (!stocks.tryRemove(it, qty)) {
+        stats.countTrade(TradeOutcome::OutOfStock);
         return 0;
     }
+    stats.countTrade(TradeOutcome::Success);
+    /* Un seul relevé du prix, qui peut changer entre deux lectures */
+    int bill = getCostPerUnit(it) * qty;
+    credit(bill);
+
+    interface->logTransaction({unsigned(uniqueId), LogKind::Sold, it, qty, bill});
+
+    interface->updateFund(uniqueId, money);
+    interface->updateStock(uniqueId, publishStocks());
+
+    return bill;
+}
 
-    resourcesProtector.lock(); // Début S.C.
-    if (stocks[it] < qty) {
-        resourcesProtector.unlock(); // Fin S.C.
+int Wholesale::tradeBatch(Order& order, BatchMode mode) {
+    int bill = reserveBatch(order, mode, ItemType::Nothing);
+
+    if (bill == 0) {
         return 0;
     }
-    stocks[it] -= qty;
-    money += getCostPerUnit(it) * qty;
-    resourcesProtector.unlock(); // Fin S.C.
 
-    interface->consoleAppendText(uniqueId, QString("I sold %1 ").arg(qty) % getItemName(it) % QString(" wich brought me %1").arg(getCostPerUnit(it) * qty));
+    interface->logTransaction({unsigned(uniqueId), LogKind::SoldBatch, ItemType::Nothing, int(order.nbLines), bill});
 
     interface->updateFund(uniqueId, money);
-    interface->updateStock(uniqueId, &stocks);
+    interface->updateStock(uniqueId, publishStocks());
 
-    return getCostPerUnit(it) * qty;
+    return bill;
 }
 
-void Wholesale::setInterface(WindowInterface *windowInterface) {
+void Wholesale::setInterface(SimulationInterface *windowInterface) {
     interface = windowInterface;
 }
+
+ShardedWholesale::ShardedWholesale(int uniqueId, int fund)
+    : Wholesale(uniqueId, fund) {}
+
+int ShardedWholesale::getFund() {
+    int total = money.load();
+    for (const Revenue& revenue : revenues) {
+        total += revenue.value.load();
+    }
+    return total;
+}
+
+void ShardedWholesale::settle() {
+    /* Les recettes passent dans les fonds sans que le total ne varie */
+    LedgerTransfer transfer;
+    for (Revenue& revenue : revenues) {
+        if (revenue.value.load(std::memory_order_relaxed)) {
+            money += revenue.value.exchange(0);
+        }
+    }
+}
+
+Step ShardedWholesale::step() {
+    settle();
+    return Wholesale::step();
+}
+
+int ShardedWholesale::trade(ItemType it, int qty) {
+    if (qty <= 0) {
+        stats.countTrade(TradeOutcome::InvalidQuantity);
+        return 0;
+    }
+    if (it == ItemType::Nothing) {
+        stats.countTrade(TradeOutcome::WrongItem);
+        return 0;
+    }
+
+    if (!stocks.tryRemove(it, qty)) {
+        stats.countTrade(TradeOutcome::OutOfStock);
+        return 0;
+    }
+    stats.countTrade(TradeOutcome::Success);
+    int bill = getCostPerUnit(it) * qty;
+    revenues[static_cast<std::size_t>(it)].value += bill;
+
+    interface->logTransaction({unsigned(uniqueId), LogKind::Sold, it, qty, bill});
+
+    return bill;
+}
+
+int ShardedWholesale::tradeBatch(Order& order, BatchMode mode) {
+    int bill = reserveBatch(order, mode, ItemType::Nothing);
+
+    if (bill > 0) {
+        interface->logTransaction({unsigned(uniqueId), LogKind::SoldBatch, ItemType::Nothing, int(order.nbLines), bill});
+    }
+    return bill;
+}
+
+void ShardedWholesale::creditSale(const Order& order, int bill) {
+    (void) bill;
+    for (std::size_t i = 0; i < order.nbLines; ++i) {
+        const OrderLine& line = order.lines[i];
+        if (line.delivered > 0) {
+            revenues[static_cast<std::size_t>(line.item)].value += line.unitPrice * line.delivered;
+        }
+    }
+}
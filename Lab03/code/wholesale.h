@@ -2,7 +2,10 @@
 #define WHOLESALE_H
 #include "seller.h"
 #include <vector>
-#include "windowinterface.h"
+#include "simulationinterface.h"
+
+// Quantité maximale demandée par un grossiste en une offre d'achat
+#define WHOLESALE_MAX_BID 5
 
 /**
  * @brief La classe permet l'implémentation d'un grossiste et de ces fonctions
@@ -14,17 +17,27 @@ private:
     // Vecteur de vendeurs (mines, usines) auxquels le grossiste peut acheter des ressources
     std::vector<Seller*> sellers;
 
-    static WindowInterface* interface;
-
     /**
      * @brief Tente d'acheter des ressources auprès d'un vendeur aléatoire.
      *
      * Cette fonction choisit un vendeur et une ressource au hasard et tente d'acheter une quantité aléatoire de cette ressource.
-     * Elle vérifie si les fonds sont suffisants avant de procéder à l'achat. Les sections critiques sont protégées par un mutex
-     * pour s'assurer que l'accès aux fonds et aux stocks est thread-safe.
+     * Elle vérifie si les fonds sont suffisants avant de procéder à l'achat. Fonds et stocks sont des compteurs atomiques :
+     * seul le thread du grossiste débite ses fonds, les ventes concurrentes ne font que les créditer.
      *
      */
     void buyResources();
+
+    /**
+     * @brief Variante de buyResources en mode place de marché.
+     *
+     * Pour chaque ressource offerte par ses vendeurs et qu'il n'a pas déjà commandée, le grossiste dépose
+     * une offre d'achat couvrant l'offre disponible (bornée par ses fonds), sans jamais appeler `trade()` à vide.
+     */
+    void bidOnMarketplace();
+
+protected:
+    static SimulationInterface* interface;
+
 public:
     /**
      * @brief Constructeur de grossiste
@@ -32,20 +45,24 @@ public:
      */
     Wholesale(int uniqueId, int fund);
 
+    bool start() override;
+
     /**
-     * @brief Routine principale du grossiste exécutée par le thread du grossiste.
+     * @brief Une étape de la routine du grossiste.
      *
-     * Cette fonction exécute une boucle qui tente continuellement d'acheter des ressources et met à jour les fonds
-     * et les stocks du grossiste. La boucle se termine proprement lorsque l'arrêt du thread est demandé.
+     * Tente d'acheter des ressources, met à jour les fonds et les stocks du grossiste, puis demande
+     * une pause avant la prochaine tentative.
      */
-    void run();
+    Step step() override;
 
-    std::map<ItemType, int> getItemsForSale() override;
+    void finish() override;
+
+    ItemsForSale getItemsForSale() override;
     /**
      * @brief Effectue une transaction de vente des ressources du grossiste.
      *
-     * Cette fonction gère la vente de ressources. Elle vérifie si la quantité demandée est disponible et si oui,
-     * elle décrémente les stocks de la ressource et incrémente les fonds du grossiste de manière thread-safe.
+     * Cette fonction gère la vente de ressources. La quantité demandée est réservée par compare-and-swap sur le
+     * compteur de la ressource, si bien que des acheteurs de ressources différentes ne se bloquent jamais.
      *
      * @param it Le type de ressource à vendre.
      * @param qty La quantité de ressource à vendre.
@@ -53,13 +70,77 @@ public:
      */
     int trade(ItemType it, int qty) override;
 
+    /**
+     * @brief Vend plusieurs ressources en une seule transaction.
+     *
+     * Toutes les lignes sont réservées avant que les fonds ne soient crédités une seule fois,
+     * et l'interface n'est mise à jour qu'une fois pour toute la commande.
+     *
+     * @param order La commande, dont les quantités livrées sont mises à jour
+     * @param mode Tout ou rien, ou au mieux du stock disponible
+     * @return La facture totale, 0 si rien n'a été livré
+     */
+    int tradeBatch(Order& order, BatchMode mode) override;
+
+    /**
+     * @brief Réception d'objets achetés sur la place de marché, aussitôt remis en vente
+     */
+    void deliver(ItemType item, int qty) override;
+
     /**
      * @brief Fonction permettant de lier des vendeurs
      * @param Vecteurs
      */
     void setSellers(std::vector<Seller*> sellers);
 
-    static void setInterface(WindowInterface* windowInterface);
+    static void setInterface(SimulationInterface* windowInterface);
+};
+
+/**
+ * @brief Grossiste dont les recettes sont réparties par type d'objet.
+ *
+ * Les stocks sont déjà un compteur atomique par type, chacun sur sa ligne de cache ; ici
+ * les recettes le sont aussi. Un acheteur ne touche donc que les lignes de cache du type
+ * qu'il achète : ni les fonds du grossiste, ni l'instantané des stocks (republié par le
+ * grossiste à chacune de ses étapes), ni son évènement de réveil, qu'il n'attend jamais.
+ * Le grossiste encaisse ses recettes au début de chaque étape, avant d'acheter.
+ */
+class ShardedWholesale : public Wholesale
+{
+public:
+    ShardedWholesale(int uniqueId, int fund);
+
+    /**
+     * @brief Fonds encaissés plus recettes de tous les types
+     */
+    int getFund() override;
+
+    Step step() override;
+
+    /**
+     * @brief Vente d'une ressource, créditée aux recettes de son type
+     */
+    int trade(ItemType it, int qty) override;
+
+    /**
+     * @brief Vente groupée, chaque ligne créditée aux recettes de son type
+     */
+    int tradeBatch(Order& order, BatchMode mode) override;
+
+protected:
+    void creditSale(const Order& order, int bill) override;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Revenue {
+        std::atomic<int> value{0};
+    };
+
+    /**
+     * @brief Verse les recettes de tous les types dans les fonds
+     */
+    void settle();
+
+    std::array<Revenue, NB_ITEM_TYPES> revenues;
 };
 
 #endif // WHOLESALE_H
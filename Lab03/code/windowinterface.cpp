@@ -1,7 +1,9 @@
 #include "windowinterface.h"
+#include <QStatusBar>
 
 bool WindowInterface::sm_didInitialize = false;
 MainWindow *WindowInterface::mainwindow = nullptr;
+unsigned int WindowInterface::sm_nbSellers = 0;
 
 WindowInterface::WindowInterface() {
     if(!sm_didInitialize){
@@ -12,30 +14,6 @@ WindowInterface::WindowInterface() {
         exit(-1);
     }
 
-    if (!QObject::connect(this,
-                          SIGNAL(sig_consoleAppendText(unsigned int,QString)),
-                          mainwindow,
-                          SLOT(consoleAppendText(unsigned int, const QString&)),
-                          Qt::QueuedConnection)) {
-            std::cout << "Error with signal-slot connection" << std::endl;
-    }
-
-    if (!QObject::connect(this,
-                          SIGNAL(sig_updateFund(unsigned int, unsigned int)),
-                          mainwindow,
-                          SLOT(updateFund(unsigned int, unsigned int)),
-                          Qt::QueuedConnection)) {
-        std::cout << "Error with signal-slot connection" << std::endl;
-    }
-
-    if (!QObject::connect(this,
-                          SIGNAL(sig_updateStock(unsigned int, std::map<ItemType, int>*)),
-                          mainwindow,
-                          SLOT(updateStock(unsigned int, std::map<ItemType, int>*)),
-                          Qt::QueuedConnection)) {
-        std::cout << "Error with signal-slot connection" << std::endl;
-    }
-
     if (!QObject::connect(this,
                           SIGNAL(sig_set_link(int, int)),
                           mainwindow,
@@ -43,19 +21,43 @@ WindowInterface::WindowInterface() {
                           Qt::QueuedConnection)) {
         std::cout << "Error with signal-slot connection" << std::endl;
     }
+
+    pendingStates = std::make_unique<PendingState[]>(sm_nbSellers);
+    pendingMessages.reserve(GUI_MAX_PENDING_MESSAGES);
+
+    // L'objet est créé par le thread graphique : le timer y tourne aussi
+    connect(&flushTimer, &QTimer::timeout, this, &WindowInterface::flush);
+    flushTimer.start(1000 / GUI_REFRESH_RATE_HZ);
 }
 
 void WindowInterface::consoleAppendText(unsigned int consoleId, QString text) {
-    emit sig_consoleAppendText(consoleId, text);
+    consoleMutex.lock(); // Début S.C.
+    if (pendingMessages.size() < GUI_MAX_PENDING_MESSAGES) {
+        pendingMessages.emplace_back(consoleId, std::move(text));
+    } else {
+        ++nbDroppedMessages;
+    }
+    consoleMutex.unlock(); // Fin S.C.
 }
 
+void WindowInterface::logTransaction(const LogRecord& record) {
+    transactions.tryPush(record);
+}
 
 void WindowInterface::updateFund(unsigned int id, unsigned new_fund) {
-    emit sig_updateFund(id, new_fund);
+    if (id >= sm_nbSellers) {
+        return;
+    }
+    pendingStates[id].fund.store(new_fund);
+    pendingStates[id].fundDirty.store(true);
 }
 
-void WindowInterface::updateStock(unsigned int id, std::map<ItemType, int>* stocks) {
-    emit sig_updateStock(id, stocks);
+void WindowInterface::updateStock(unsigned int id, const SeqLock<ItemsForSale>* stocks) {
+    if (id >= sm_nbSellers) {
+        return;
+    }
+    pendingStates[id].stocks.store(stocks);
+    pendingStates[id].stockDirty.store(true);
 }
 
 void WindowInterface::setLink(int from, int to){
@@ -72,6 +74,7 @@ void WindowInterface::initialize(unsigned int nbExtractors, unsigned int nbFacto
                 return;
     }
 
+    sm_nbSellers = nbExtractors + nbFactories + nbWholesalers;
     mainwindow = new MainWindow(nbExtractors, nbFactories, nbWholesalers, nullptr);
     mainwindow->show();
     sm_didInitialize = true;
@@ -82,3 +85,69 @@ void WindowInterface::setUtils(Utils* utils)
 {
     mainwindow->setUtils(utils);
 }
+
+void WindowInterface::flush()
+{
+    for (unsigned int id = 0; id < sm_nbSellers; ++id) {
+        PendingState& state = pendingStates[id];
+        if (state.fundDirty.exchange(false)) {
+            mainwindow->updateFund(id, state.fund.load());
+        }
+        if (state.stockDirty.exchange(false)) {
+            std::uint64_t epoch;
+            ItemsForSale stocks = state.stocks.load()->read(&epoch);
+            if (epoch != state.displayedEpoch) {
+                state.displayedEpoch = epoch;
+                mainwindow->updateStock(id, stocks);
+            }
+        }
+    }
+
+    std::vector<std::pair<unsigned int, QString>> messages;
+    messages.reserve(GUI_MAX_PENDING_MESSAGES);
+
+    consoleMutex.lock(); // Début S.C.
+    messages.swap(pendingMessages);
+    unsigned int nbDropped = nbDroppedMessages;
+    nbDroppedMessages = 0;
+    consoleMutex.unlock(); // Fin S.C.
+
+    // Un seul ajout par console et par rafraîchissement
+    std::vector<QString> texts(sm_nbSellers);
+    for (auto& message : messages) {
+        if (message.first >= sm_nbSellers) {
+            continue;
+        }
+        QString& text = texts[message.first];
+        if (!text.isEmpty()) {
+            text += QLatin1Char('\n');
+        }
+        text += message.second;
+    }
+
+    LogRecord record;
+    while (transactions.tryPop(record)) {
+        if (record.consoleId >= sm_nbSellers) {
+            continue;
+        }
+        QString& text = texts[record.consoleId];
+        if (!text.isEmpty()) {
+            text += QLatin1Char('\n');
+        }
+        text += formatLogRecord(record);
+    }
+    std::uint64_t nbLost = transactions.getNbDropped();
+    nbDropped += unsigned(nbLost - nbDroppedTransactions);
+    nbDroppedTransactions = nbLost;
+
+    for (unsigned int id = 0; id < sm_nbSellers; ++id) {
+        if (!texts[id].isEmpty()) {
+            mainwindow->consoleAppendText(id, texts[id]);
+        }
+    }
+
+    /* Affiché dans la barre d'état de la fenêtre, deux secondes après la dernière perte */
+    if (nbDropped) {
+        mainwindow->statusBar()->showMessage(QString("%1 console messages dropped").arg(nbDropped), 2000);
+    }
+}
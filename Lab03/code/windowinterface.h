@@ -2,14 +2,39 @@
 #define WINDOWINTERFACE_H
 
 #include <QObject>
+#include <QTimer>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <QMessageBox>
+#include <pcosynchro/pcomutex.h>
 #include "mainwindow.h"
 #include "seller.h"
+#include "simulationinterface.h"
+#include "transactionlog.h"
+
+// Fréquence maximale de rafraîchissement de la fenêtre
+#define GUI_REFRESH_RATE_HZ 30
+// Nombre maximal de messages de console conservés entre deux rafraîchissements
+#define GUI_MAX_PENDING_MESSAGES 2000
 
 class Utils;
 
-class WindowInterface : public QObject
+/**
+ * @brief Implémentation graphique de SimulationInterface.
+ *
+ * Les threads des vendeurs ne font que noter l'état à afficher : dernier montant des
+ * fonds et instantané des stocks à relire (par vendeur), messages de console en attente.
+ * Les stocks sont lus dans l'instantané publié par le vendeur (SeqLock), jamais dans
+ * ses compteurs vivants : la fenêtre affiche un état cohérent sans prendre de verrou.
+ * Un timer du thread graphique vide cet état au plus GUI_REFRESH_RATE_HZ fois par seconde,
+ * de sorte que des milliers d'échanges par seconde ne produisent que quelques
+ * dizaines de mises à jour de la fenêtre.
+ * Les messages d'échange arrivent sous forme binaire dans une TransactionLog, sans
+ * verrou ; seul le thread graphique les met en texte, au moment de les afficher.
+ */
+class WindowInterface : public QObject, public SimulationInterface
 {
     Q_OBJECT
 
@@ -20,23 +45,50 @@ public:
 
     static void initialize(unsigned int nbExtractors, unsigned int nbFactories, unsigned int nbWholesalers);
 
-    void consoleAppendText(unsigned int consoleId, QString text);
+    void consoleAppendText(unsigned int consoleId, QString text) override;
+    void logTransaction(const LogRecord& record) override;
 
-    void updateFund(unsigned int id, unsigned new_fund);
-    void updateStock(unsigned int id, std::map<ItemType, int>* stocks);
-    void setLink(int from, int to);
+    void updateFund(unsigned int id, unsigned new_fund) override;
+    void updateStock(unsigned int id, const SeqLock<ItemsForSale>* stocks) override;
+    void setLink(int from, int to) override;
     void setUtils(Utils* utils);
 
 private:
     static bool sm_didInitialize;
     static MainWindow *mainwindow;
+    static unsigned int sm_nbSellers;
 
+    /**
+     * @brief État d'un vendeur en attente d'affichage
+     */
+    struct PendingState {
+        std::atomic<unsigned> fund{0};
+        std::atomic<bool> fundDirty{false};
+        std::atomic<const SeqLock<ItemsForSale>*> stocks{nullptr};
+        std::atomic<bool> stockDirty{false};
+        // Époque du dernier instantané affiché, lue et écrite par le seul thread graphique
+        std::uint64_t displayedEpoch = 0;
+    };
 
-signals:
-    void sig_consoleAppendText(unsigned int consoleId, QString text);
+    std::unique_ptr<PendingState[]> pendingStates;
+
+    PcoMutex consoleMutex;
+    std::vector<std::pair<unsigned int, QString>> pendingMessages;
+    unsigned int nbDroppedMessages = 0;
+
+    // Messages d'échange, vidés par le seul thread graphique
+    TransactionLog transactions{GUI_MAX_PENDING_MESSAGES};
+    std::uint64_t nbDroppedTransactions = 0;
 
-    void sig_updateFund(unsigned int id, unsigned new_fund);
-    void sig_updateStock(unsigned int id, std::map<ItemType, int>* stocks);
+    QTimer flushTimer;
+
+private slots:
+    /**
+     * @brief Reporte dans la fenêtre tout ce qui a changé depuis le dernier rafraîchissement
+     */
+    void flush();
+
+signals:
     void sig_set_link(int from, int to);
 };
 
@@ -0,0 +1,209 @@
+/**
+ * @file workstealingpool.cpp
+ * @brief Exécution des routines des vendeurs comme tâches coopératives sur un pool de threads.
+ * @date 2026-10-18
+ * @author Christen Anthony, Harun Ouweis
+ */
+
+#include "workstealingpool.h"
+#include "seller.h"
+#include "threadrandom.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+// Indice de la file du thread courant, -1 hors du pool
+thread_local int currentWorker = -1;
+}
+
+WorkStealingPool::WorkStealingPool(unsigned nbWorkers, SimulationClock* clock)
+    : nbWorkers(nbWorkers ? nbWorkers : std::max(1u, std::thread::hardware_concurrency())),
+      clock(clock), workers(new Worker[this->nbWorkers]) {}
+
+void WorkStealingPool::addSeller(Seller* seller) {
+    tasks.push_back(std::make_unique<Task>(this, seller));
+    seller->getWakeup().setListener(tasks.back().get());
+}
+
+void WorkStealingPool::Task::onSignal(Wakeup* wakeup) {
+    TaskState expected = TaskState::Parked;
+    if (state.compare_exchange_strong(expected, TaskState::Queued)) {
+        wakeup->tryConsume();
+        pool->push(this);
+    }
+}
+
+void WorkStealingPool::push(Task* task, bool yield) {
+    unsigned index = currentWorker >= 0 ? unsigned(currentWorker) : nextWorker++ % nbWorkers;
+    Worker& worker = workers[index];
+
+    worker.mutex.lock(); // Début S.C.
+    if (yield) {
+        worker.tasks.push_front(task);
+    } else {
+        worker.tasks.push_back(task);
+    }
+    worker.mutex.unlock(); // Fin S.C.
+
+    ++nbQueued;
+    /* Réveil d'un thread inactif, qui volera la tâche au besoin */
+    if (nbIdle.load() > 0) {
+        idleMutex.lock(); // Début S.C.
+        idleCond.notifyOne();
+        idleMutex.unlock(); // Fin S.C.
+    }
+}
+
+WorkStealingPool::Task* WorkStealingPool::take(unsigned index) {
+    Task* task = nullptr;
+    Worker& own = workers[index];
+
+    own.mutex.lock(); // Début S.C.
+    if (!own.tasks.empty()) {
+        task = own.tasks.back();
+        own.tasks.pop_back();
+    }
+    own.mutex.unlock(); // Fin S.C.
+
+    /* File vide : vol au début de la file des autres, à partir d'une victime au hasard */
+    unsigned first = unsigned(ThreadRandom::bounded(0, int(nbWorkers) - 1));
+    for (unsigned i = 0; !task && i < nbWorkers; ++i) {
+        unsigned victimIndex = (first + i) % nbWorkers;
+        if (victimIndex == index) {
+            continue;
+        }
+        Worker& victim = workers[victimIndex];
+
+        victim.mutex.lock(); // Début S.C.
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            ++nbSteals;
+        }
+        victim.mutex.unlock(); // Fin S.C.
+    }
+
+    if (task) {
+        --nbQueued;
+    }
+    return task;
+}
+
+void WorkStealingPool::execute(Task* task) {
+    task->state = TaskState::Running;
+    FastClock::setThreadTimeline(&task->simulatedTime);
+    Step next = task->seller->advance();
+    ++nbSteps;
+
+    if (next.kind == Step::Kind::Sleep) {
+        std::uint64_t realUs = clock->elapse(next.delayUs);
+        FastClock::setThreadTimeline(nullptr);
+        if (realUs == 0) {
+            task->state = TaskState::Queued;
+            push(task, true);
+        } else {
+            task->state = TaskState::Sleeping;
+            sleep(task, realUs);
+        }
+        return;
+    }
+
+    FastClock::setThreadTimeline(nullptr);
+
+    /* Attente : la tâche quitte les files jusqu'à un signal, sauf s'il est déjà arrivé */
+    task->state = TaskState::Parked;
+    TaskState expected = TaskState::Parked;
+    if (task->seller->getWakeup().tryConsume() &&
+        task->state.compare_exchange_strong(expected, TaskState::Queued)) {
+        push(task);
+    }
+}
+
+void WorkStealingPool::sleep(Task* task, std::uint64_t realUs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(realUs);
+
+    timerMutex.lock(); // Début S.C.
+    timers.push({deadline, nextSequence++, task});
+    timerMutex.unlock(); // Fin S.C.
+}
+
+void WorkStealingPool::work(unsigned index) {
+    currentWorker = int(index);
+    /* Le choix des victimes ne dépend que de la graine et de l'indice du thread */
+    ThreadRandom::bindStream(POOL_WORKER_STREAM_BASE + index);
+
+    while (!stopping.load()) {
+        Task* task = take(index);
+        if (task) {
+            execute(task);
+            continue;
+        }
+
+        idleMutex.lock(); // Début S.C.
+        ++nbIdle;
+        while (nbQueued.load() <= 0 && !stopping.load()) {
+            idleCond.wait(&idleMutex);
+        }
+        --nbIdle;
+        idleMutex.unlock(); // Fin S.C.
+    }
+}
+
+void WorkStealingPool::run() {
+    std::vector<Task*> started;
+
+    for (auto& task : tasks) {
+        if (task->seller->start()) {
+            started.push_back(task.get());
+        }
+    }
+    for (Task* task : started) {
+        push(task);
+    }
+
+    for (unsigned i = 0; i < nbWorkers; ++i) {
+        threads.emplace_back(std::make_unique<PcoThread>(&WorkStealingPool::work, this, i));
+    }
+
+    /* Minuteur : remet dans les files les tâches dont la pause est écoulée */
+    std::vector<Task*> due;
+    while (!stopping.load()) {
+        auto now = std::chrono::steady_clock::now();
+        std::uint64_t waitUs = POOL_TIMER_RESOLUTION_US;
+
+        timerMutex.lock(); // Début S.C.
+        while (!timers.empty() && timers.top().deadline <= now) {
+            due.push_back(timers.top().task);
+            timers.pop();
+        }
+        if (!timers.empty()) {
+            auto untilNext = std::chrono::duration_cast<std::chrono::microseconds>(timers.top().deadline - now).count();
+            waitUs = std::min<std::uint64_t>(waitUs, std::uint64_t(untilNext));
+        }
+        timerMutex.unlock(); // Fin S.C.
+
+        for (Task* task : due) {
+            task->state = TaskState::Queued;
+            push(task);
+        }
+        due.clear();
+
+        PcoThread::usleep(waitUs);
+    }
+
+    for (auto& thread : threads) {
+        thread->join();
+    }
+
+    for (Task* task : started) {
+        task->seller->finish();
+    }
+}
+
+void WorkStealingPool::stop() {
+    stopping = true;
+
+    idleMutex.lock(); // Début S.C.
+    idleCond.notifyAll();
+    idleMutex.unlock(); // Fin S.C.
+}
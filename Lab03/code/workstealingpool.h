@@ -0,0 +1,167 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+#include <pcosynchro/pcomutex.h>
+#include <pcosynchro/pcoconditionvariable.h>
+#include <pcosynchro/pcothread.h>
+#include "itemtype.h"
+#include "restocknotifier.h"
+#include "simulationclock.h"
+
+class Seller;
+
+// Résolution du minuteur des pauses, en microsecondes
+#define POOL_TIMER_RESOLUTION_US 1000
+// Premier flux aléatoire des threads du pool, loin des identifiants des vendeurs
+#define POOL_WORKER_STREAM_BASE (1ULL << 48)
+
+/**
+ * @brief Exécuteur à vol de tâches : un nombre fixe de threads pour tous les vendeurs.
+ *
+ * Les routines des vendeurs sont des tâches coopératives : chaque étape (Seller::step)
+ * s'exécute sur un thread du pool, puis rend la main. Chaque thread a sa propre file ;
+ * il y prend ses tâches par la fin (les plus récentes, encore en cache) et, lorsqu'elle
+ * est vide, en vole une au début de la file d'un autre. Une pause passe par un minuteur
+ * commun au lieu de bloquer un thread ; un vendeur qui attend un réveil n'occupe aucune
+ * file jusqu'au signal de son évènement, qui le remet dans la file du thread signaleur.
+ */
+class WorkStealingPool
+{
+public:
+    /**
+     * @param nbWorkers Nombre de threads, 0 pour le nombre de cœurs de la machine
+     * @param clock Horloge qui convertit les pauses simulées en temps réel
+     */
+    WorkStealingPool(unsigned nbWorkers, SimulationClock* clock);
+
+    /**
+     * @brief Confie un vendeur au pool. À appeler avant run().
+     * @param seller Le vendeur, dont les signaux de réveil sont redirigés vers le pool
+     */
+    void addSeller(Seller* seller);
+
+    /**
+     * @brief Lance les threads du pool puis sert de minuteur, jusqu'à l'appel de stop()
+     */
+    void run();
+
+    /**
+     * @brief Demande l'arrêt du pool
+     */
+    void stop();
+
+    unsigned getNbWorkers() const { return nbWorkers; }
+
+    /**
+     * @brief Nombre d'étapes exécutées depuis le lancement
+     */
+    std::uint64_t getNbSteps() const { return nbSteps.load(); }
+
+    /**
+     * @brief Nombre de tâches prises dans la file d'un autre thread
+     */
+    std::uint64_t getNbSteals() const { return nbSteals.load(); }
+
+private:
+    enum class TaskState {
+        Queued,   // Dans la file d'un thread
+        Running,  // En cours d'exécution
+        Sleeping, // Chez le minuteur
+        Parked    // En attente d'un signal de réveil
+    };
+
+    /**
+     * @brief Un vendeur vu par le pool
+     */
+    struct Task : public WakeupListener {
+        WorkStealingPool* pool;
+        Seller* seller;
+        std::atomic<TaskState> state{TaskState::Queued};
+        // Temps simulé propre à la tâche, avancé par ses pauses avec FastClock
+        std::uint64_t simulatedTime = 0;
+
+        Task(WorkStealingPool* pool, Seller* seller) : pool(pool), seller(seller) {}
+
+        void onSignal(Wakeup* wakeup) override;
+    };
+
+    /**
+     * @brief File d'un thread du pool, seule sur sa ligne de cache
+     */
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        PcoMutex mutex;
+        std::deque<Task*> tasks;
+    };
+
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        std::uint64_t sequence;
+        Task* task;
+
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    /**
+     * @brief Routine d'un thread du pool
+     * @param index Indice de sa file
+     */
+    void work(unsigned index);
+
+    /**
+     * @brief Prend une tâche dans sa propre file, sinon en vole une
+     * @return La tâche, nullptr si toutes les files sont vides
+     */
+    Task* take(unsigned index);
+
+    /**
+     * @brief Exécute une étape d'une tâche et programme sa suite
+     */
+    void execute(Task* task);
+
+    /**
+     * @brief Met une tâche dans une file : celle du thread appelant s'il est du pool
+     * @param task La tâche
+     * @param yield La tâche rend la main sans attendre : elle passe après les autres
+     */
+    void push(Task* task, bool yield = false);
+
+    /**
+     * @brief Confie une tâche au minuteur
+     */
+    void sleep(Task* task, std::uint64_t realUs);
+
+    const unsigned nbWorkers;
+    SimulationClock* clock;
+
+    std::vector<std::unique_ptr<Task>> tasks;
+    std::unique_ptr<Worker[]> workers;
+    std::vector<std::unique_ptr<PcoThread>> threads;
+
+    // Tâches présentes dans l'ensemble des files
+    std::atomic<int> nbQueued{0};
+    std::atomic<int> nbIdle{0};
+    std::atomic<unsigned> nextWorker{0};
+    std::atomic<bool> stopping{false};
+
+    PcoMutex idleMutex;
+    PcoConditionVariable idleCond;
+
+    PcoMutex timerMutex;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::uint64_t nextSequence = 0;
+
+    std::atomic<std::uint64_t> nbSteps{0};
+    std::atomic<std::uint64_t> nbSteals{0};
+};
+
+#endif // WORKSTEALINGPOOL_H